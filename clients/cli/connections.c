@@ -2341,6 +2341,7 @@ typedef struct {
 	NmCli *nmc;
 	NMDevice *device;
 	NMActiveConnection *active;
+	guint timeout_id;
 } ActivateConnectionInfo;
 
 static void activate_connection_info_finish (ActivateConnectionInfo *info);
@@ -2414,6 +2415,8 @@ activate_connection_timeout_cb (gpointer user_data)
 {
 	ActivateConnectionInfo *info = user_data;
 
+	info->timeout_id = 0;
+
 	/* Time expired -> exit nmcli */
 	set_nmc_error_timeout (info->nmc);
 	activate_connection_info_finish (info);
@@ -2462,6 +2465,8 @@ progress_active_connection_cb (gpointer user_data)
 static void
 activate_connection_info_finish (ActivateConnectionInfo *info)
 {
+	nm_clear_g_source (&info->timeout_id);
+
 	if (info->device) {
 		g_signal_handlers_disconnect_by_func (info->device, G_CALLBACK (device_state_cb), info);
 		g_object_unref (info->device);
@@ -2534,7 +2539,7 @@ activate_connection_cb (GObject *client, GAsyncResult *result, gpointer user_dat
 			}
 
 			/* Start timer not to loop forever when signals are not emitted */
-			g_timeout_add_seconds (nmc->timeout, activate_connection_timeout_cb, info);
+			info->timeout_id = g_timeout_add_seconds (nmc->timeout, activate_connection_timeout_cb, info);
 		}
 	}
 }
@@ -1812,27 +1812,75 @@ progress_cb (gpointer user_data)
 	return TRUE;
 }
 
-static void connected_state_cb (NMDevice *device, NMActiveConnection *active);
+typedef struct {
+	NmCli *nmc;
+	NMDevice *device;
+	NMActiveConnection *active;
+	guint timeout_id;
+} ConnectedWaitData;
+
+static void connected_state_cb (ConnectedWaitData *data);
 
 static void
 device_state_cb (NMDevice *device, GParamSpec *pspec, gpointer user_data)
 {
-	NMActiveConnection *active = (NMActiveConnection *) user_data;
-
-	connected_state_cb (device, active);
+	connected_state_cb (user_data);
 }
 
 static void
 active_state_cb (NMActiveConnection *active, GParamSpec *pspec, gpointer user_data)
 {
-	NMDevice *device = (NMDevice *) user_data;
+	connected_state_cb (user_data);
+}
+
+static void
+connected_wait_finish (ConnectedWaitData *data)
+{
+	nm_clear_g_source (&data->timeout_id);
+	g_signal_handlers_disconnect_by_func (data->active, G_CALLBACK (active_state_cb), data);
+	g_signal_handlers_disconnect_by_func (data->device, G_CALLBACK (device_state_cb), data);
+	g_object_unref (data->active);
+	g_object_unref (data->device);
+	g_slice_free (ConnectedWaitData, data);
+	quit ();
+}
 
-	connected_state_cb (device, active);
+static gboolean
+connected_timeout_cb (gpointer user_data)
+{
+	ConnectedWaitData *data = user_data;
+
+	data->timeout_id = 0;
+	timeout_cb (data->nmc);
+	connected_wait_finish (data);
+	return G_SOURCE_REMOVE;
 }
 
+/* Waits until @device is activated with @active, taking a reference to
+ * @device and the reference of @active. The wait ends when the activation
+ * completes or fails, or the timeout expires. */
 static void
-connected_state_cb (NMDevice *device, NMActiveConnection *active)
+connected_wait_start (NmCli *nmc, NMDevice *device, NMActiveConnection *active)
 {
+	ConnectedWaitData *data;
+
+	data = g_slice_new (ConnectedWaitData);
+	data->nmc = nmc;
+	data->device = g_object_ref (device);
+	data->active = active;
+
+	g_signal_connect (device, "notify::state", G_CALLBACK (device_state_cb), data);
+	g_signal_connect (active, "notify::state", G_CALLBACK (active_state_cb), data);
+
+	/* Start timer not to loop forever if "notify::state" signal is not issued */
+	data->timeout_id = g_timeout_add_seconds (nmc->timeout, connected_timeout_cb, data);
+}
+
+static void
+connected_state_cb (ConnectedWaitData *data)
+{
+	NMDevice *device = data->device;
+	NMActiveConnection *active = data->active;
 	NMDeviceState state;
 	NMDeviceStateReason reason;
 	NMActiveConnectionState ac_state;
@@ -1856,13 +1904,7 @@ connected_state_cb (NMDevice *device, NMActiveConnection *active)
 	} else
 		return;
 
-	g_signal_handlers_disconnect_by_func (active, G_CALLBACK (active_state_cb), device);
-	g_signal_handlers_disconnect_by_func (device, G_CALLBACK (device_state_cb), active);
-
-	g_object_unref (active);
-	g_object_unref (device);
-
-	quit ();
+	connected_wait_finish (data);
 }
 
 typedef struct {
@@ -1923,11 +1965,7 @@ add_and_activate_cb (GObject *client,
 			g_object_unref (active);
 			quit ();
 		} else {
-			g_object_ref (device);
-			g_signal_connect (device, "notify::state", G_CALLBACK (device_state_cb), active);
-			g_signal_connect (active, "notify::state", G_CALLBACK (active_state_cb), device);
-
-			g_timeout_add_seconds (nmc->timeout, timeout_cb, nmc);  /* Exit if timeout expires */
+			connected_wait_start (nmc, device, active);
 
 			if (nmc->nmc_config.print_output == NMC_PRINT_PRETTY)
 				progress_id = g_timeout_add (120, progress_cb, device);
@@ -2017,11 +2055,7 @@ connect_device_cb (GObject *client, GAsyncResult *result, gpointer user_data)
 				                               nm_connection_get_path (NM_CONNECTION (connection)));
 			}
 
-			g_object_ref (device);
-			g_signal_connect (device, "notify::state", G_CALLBACK (device_state_cb), active);
-			g_signal_connect (active, "notify::state", G_CALLBACK (active_state_cb), device);
-			/* Start timer not to loop forever if "notify::state" signal is not issued */
-			g_timeout_add_seconds (nmc->timeout, timeout_cb, nmc);
+			connected_wait_start (nmc, device, active);
 		}
 	}
 	g_free (info);
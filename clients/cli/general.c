@@ -346,15 +346,151 @@ static const NmcMetaGenericInfo *const metagen_general_logging[_NMC_GENERIC_INFO
 
 /*****************************************************************************/
 
+typedef struct {
+	const char *name;
+	guint32 count;
+} DebugMemoryData;
+
+static gconstpointer
+_metagen_general_debug_memory_get_fcn (NMC_META_GENERIC_INFO_GET_FCN_ARGS)
+{
+	const DebugMemoryData *d = target;
+
+	NMC_HANDLE_COLOR (NM_META_COLOR_NONE);
+
+	switch (info->info_type) {
+	case NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_MEMORY_NAME:
+		return d->name;
+	case NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_MEMORY_COUNT:
+		return (*out_to_free = g_strdup_printf ("%u", (guint) d->count));
+	default:
+		break;
+	}
+
+	g_return_val_if_reached (NULL);
+}
+
+static const NmcMetaGenericInfo *const metagen_general_debug_memory[_NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_MEMORY_NUM + 1] = {
+#define _METAGEN_GENERAL_DEBUG_MEMORY(type, name) \
+	[type] = NMC_META_GENERIC(name, .info_type = type, .get_fcn = _metagen_general_debug_memory_get_fcn)
+	_METAGEN_GENERAL_DEBUG_MEMORY (NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_MEMORY_NAME,  "NAME"),
+	_METAGEN_GENERAL_DEBUG_MEMORY (NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_MEMORY_COUNT, "COUNT"),
+};
+
+/*****************************************************************************/
+
+typedef struct {
+	const char *name;
+	guint64 count;
+	guint64 total_ns;
+	guint64 max_ns;
+	const guint64 *buckets;
+	gsize n_buckets;
+} DebugLatencyData;
+
+/* Returns the upper bound of the histogram bucket that contains the
+ * @percent percentile. Bucket i holds durations of i significant bits. */
+static guint64
+debug_percentile (const DebugLatencyData *d, guint percent)
+{
+	guint64 needed = (d->count * percent + 99) / 100;
+	guint64 sum = 0;
+	gsize i;
+
+	for (i = 0; i < d->n_buckets; i++) {
+		sum += d->buckets[i];
+		if (sum >= needed)
+			break;
+	}
+	if (i + 1 >= d->n_buckets)
+		return d->max_ns;
+	return MIN (((guint64) 1) << i, d->max_ns);
+}
+
+static char *
+debug_format_ns (guint64 ns, NMMetaAccessorGetType get_type)
+{
+	if (get_type != NM_META_ACCESSOR_GET_TYPE_PRETTY)
+		return g_strdup_printf ("%"G_GUINT64_FORMAT, ns);
+	if (ns < 1000)
+		return g_strdup_printf ("%"G_GUINT64_FORMAT"ns", ns);
+	if (ns < 1000000)
+		return g_strdup_printf ("%.1fus", ns / 1000.0);
+	if (ns < 1000000000)
+		return g_strdup_printf ("%.1fms", ns / 1000000.0);
+	return g_strdup_printf ("%.2fs", ns / 1000000000.0);
+}
+
+static gconstpointer
+_metagen_general_debug_latency_get_fcn (NMC_META_GENERIC_INFO_GET_FCN_ARGS)
+{
+	const DebugLatencyData *d = target;
+	guint64 ns;
+
+	NMC_HANDLE_COLOR (NM_META_COLOR_NONE);
+
+	switch (info->info_type) {
+	case NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_OPERATION:
+		return d->name;
+	case NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_COUNT:
+		return (*out_to_free = g_strdup_printf ("%"G_GUINT64_FORMAT, d->count));
+	case NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_AVG:
+		if (d->count == 0)
+			return NULL;
+		ns = d->total_ns / d->count;
+		break;
+	case NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_P50:
+		if (d->count == 0)
+			return NULL;
+		ns = debug_percentile (d, 50);
+		break;
+	case NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_P90:
+		if (d->count == 0)
+			return NULL;
+		ns = debug_percentile (d, 90);
+		break;
+	case NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_P99:
+		if (d->count == 0)
+			return NULL;
+		ns = debug_percentile (d, 99);
+		break;
+	case NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_MAX:
+		if (d->count == 0)
+			return NULL;
+		ns = d->max_ns;
+		break;
+	default:
+		g_return_val_if_reached (NULL);
+	}
+
+	return (*out_to_free = debug_format_ns (ns, get_type));
+}
+
+static const NmcMetaGenericInfo *const metagen_general_debug_latency[_NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_NUM + 1] = {
+#define _METAGEN_GENERAL_DEBUG_LATENCY(type, name) \
+	[type] = NMC_META_GENERIC(name, .info_type = type, .get_fcn = _metagen_general_debug_latency_get_fcn)
+	_METAGEN_GENERAL_DEBUG_LATENCY (NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_OPERATION, "OPERATION"),
+	_METAGEN_GENERAL_DEBUG_LATENCY (NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_COUNT,     "COUNT"),
+	_METAGEN_GENERAL_DEBUG_LATENCY (NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_AVG,       "AVG"),
+	_METAGEN_GENERAL_DEBUG_LATENCY (NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_P50,       "P50"),
+	_METAGEN_GENERAL_DEBUG_LATENCY (NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_P90,       "P90"),
+	_METAGEN_GENERAL_DEBUG_LATENCY (NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_P99,       "P99"),
+	_METAGEN_GENERAL_DEBUG_LATENCY (NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_MAX,       "MAX"),
+};
+
+/*****************************************************************************/
+
 static void
 usage_general (void)
 {
 	g_printerr (_("Usage: nmcli general { COMMAND | help }\n\n"
-	              "COMMAND := { status | hostname | permissions | logging }\n\n"
+	              "COMMAND := { status | hostname | permissions | logging | dump | debug }\n\n"
 	              "  status\n\n"
 	              "  hostname [<hostname>]\n\n"
 	              "  permissions\n\n"
-	              "  logging [level <log level>] [domains <log domains>]\n\n"));
+	              "  logging [level <log level>] [domains <log domains>]\n\n"
+	              "  dump [connections] [devices] [active]\n\n"
+	              "  debug { memory | latency }\n\n"));
 }
 
 static void
@@ -399,6 +535,32 @@ usage_general_logging (void)
 	              "for the list of possible logging domains.\n\n"));
 }
 
+static void
+usage_general_dump (void)
+{
+	g_printerr (_("Usage: nmcli general dump { ARGUMENTS | help }\n"
+	              "\n"
+	              "ARGUMENTS := [connections] [devices] [active]\n"
+	              "\n"
+	              "Print connection profiles with all their settings, devices and active\n"
+	              "connections with their IP configuration as a single JSON document.\n"
+	              "Without arguments, all of them are printed.\n\n"));
+}
+
+static void
+usage_general_debug (void)
+{
+	g_printerr (_("Usage: nmcli general debug { ARGUMENTS | help }\n"
+	              "\n"
+	              "ARGUMENTS := { memory | latency }\n"
+	              "\n"
+	              "Print internal statistics of NetworkManager, meant for debugging.\n"
+	              "\"memory\" prints how many objects of various kinds NetworkManager\n"
+	              "holds in memory. \"latency\" prints how long NetworkManager took for\n"
+	              "frequently run operations, with the percentiles given as upper bounds.\n"
+	              "In terse mode, durations are printed in nanoseconds.\n\n"));
+}
+
 static void
 usage_networking (void)
 {
@@ -531,11 +693,29 @@ do_general_status (NmCli *nmc, int argc, char **argv)
 	return nmc->return_value;
 }
 
+static guint permissions_timeout_id = 0;
+
+static void permission_changed (NMClient *client,
+                                NMClientPermission permission,
+                                NMClientPermissionResult result,
+                                NmCli *nmc);
+
+static void
+permissions_wait_finish (NmCli *nmc)
+{
+	nm_clear_g_source (&permissions_timeout_id);
+	g_signal_handlers_disconnect_by_func (nmc->client, G_CALLBACK (permission_changed), nmc);
+	g_idle_remove_by_data (nmc);
+}
+
 static gboolean
 timeout_cb (gpointer user_data)
 {
 	NmCli *nmc = (NmCli *) user_data;
 
+	permissions_timeout_id = 0;
+	permissions_wait_finish (nmc);
+
 	g_string_printf (nmc->return_text, _("Error: Timeout %d sec expired."), nmc->timeout);
 	nmc->return_value = NMC_RESULT_ERROR_TIMEOUT_EXPIRED;
 	quit ();
@@ -552,6 +732,8 @@ print_permissions (void *user_data)
 	guint i;
 	gpointer permissions[NM_CLIENT_PERMISSION_LAST + 1];
 
+	permissions_wait_finish (nmc);
+
 	if (!nmc->required_fields || strcasecmp (nmc->required_fields, "common") == 0) {
 	} else if (strcasecmp (nmc->required_fields, "all") == 0) {
 	} else
@@ -623,7 +805,7 @@ show_nm_permissions (NmCli *nmc)
 
 	if (nmc->timeout == -1)
 		nmc->timeout = 10;
-	g_timeout_add_seconds (nmc->timeout, timeout_cb, nmc);
+	permissions_timeout_id = g_timeout_add_seconds (nmc->timeout, timeout_cb, nmc);
 
 	nmc->should_wait++;
 	return TRUE;
@@ -801,11 +983,339 @@ do_general_hostname (NmCli *nmc, int argc, char **argv)
 
 }
 
+static void
+dump_ip_configs (GString *str,
+                 const NmcConfig *nmc_config,
+                 NMIPConfig *ip4,
+                 NMDhcpConfig *dhcp4,
+                 NMIPConfig *ip6,
+                 NMDhcpConfig *dhcp6)
+{
+	g_string_append (str, ",\"IP4\":");
+	if (ip4)
+		nmc_json_append_fields (str, nmc_config, (const NMMetaAbstractInfo *const*) metagen_ip4_config, ip4, NULL);
+	else
+		g_string_append (str, "null");
+
+	g_string_append (str, ",\"DHCP4\":");
+	if (dhcp4)
+		nmc_json_append_fields (str, nmc_config, (const NMMetaAbstractInfo *const*) metagen_dhcp_config, dhcp4, NULL);
+	else
+		g_string_append (str, "null");
+
+	g_string_append (str, ",\"IP6\":");
+	if (ip6)
+		nmc_json_append_fields (str, nmc_config, (const NMMetaAbstractInfo *const*) metagen_ip6_config, ip6, NULL);
+	else
+		g_string_append (str, "null");
+
+	g_string_append (str, ",\"DHCP6\":");
+	if (dhcp6)
+		nmc_json_append_fields (str, nmc_config, (const NMMetaAbstractInfo *const*) metagen_dhcp_config, dhcp6, NULL);
+	else
+		g_string_append (str, "null");
+}
+
+static void
+dump_connection (GString *str, const NmcConfig *nmc_config, NMConnection *connection)
+{
+	gboolean first = TRUE;
+	guint i;
+
+	g_string_append (str, "{\"path\":");
+	nmc_json_append_string (str, nm_connection_get_path (connection));
+	g_string_append (str, ",\"settings\":{");
+	for (i = 0; i < _NM_META_SETTING_TYPE_NUM; i++) {
+		const NMMetaSettingInfoEditor *setting_info = &nm_meta_setting_infos_editor[i];
+		NMSetting *setting;
+
+		setting = nm_connection_get_setting_by_name (connection, setting_info->general->setting_name);
+		if (!setting)
+			continue;
+
+		if (!first)
+			g_string_append_c (str, ',');
+		first = FALSE;
+
+		nmc_json_append_string (str, setting_info->general->setting_name);
+		g_string_append_c (str, ':');
+		nmc_json_append_fields (str,
+		                        nmc_config,
+		                        (const NMMetaAbstractInfo *const*) setting_info->properties,
+		                        setting,
+		                        NULL);
+	}
+	g_string_append (str, "}}");
+}
+
+static void
+dump_device (GString *str, const NmcConfig *nmc_config, NMDevice *device)
+{
+	g_string_append (str, "{\"path\":");
+	nmc_json_append_string (str, nm_object_get_path (NM_OBJECT (device)));
+	g_string_append (str, ",\"GENERAL\":");
+	nmc_json_append_fields (str,
+	                        nmc_config,
+	                        (const NMMetaAbstractInfo *const*) metagen_device_detail_general,
+	                        device,
+	                        NULL);
+	dump_ip_configs (str,
+	                 nmc_config,
+	                 nm_device_get_ip4_config (device),
+	                 nm_device_get_dhcp4_config (device),
+	                 nm_device_get_ip6_config (device),
+	                 nm_device_get_dhcp6_config (device));
+	g_string_append_c (str, '}');
+}
+
+static void
+dump_active_connection (GString *str, const NmcConfig *nmc_config, NMActiveConnection *ac)
+{
+	g_string_append (str, "{\"path\":");
+	nmc_json_append_string (str, nm_object_get_path (NM_OBJECT (ac)));
+	g_string_append (str, ",\"GENERAL\":");
+	nmc_json_append_fields (str,
+	                        nmc_config,
+	                        (const NMMetaAbstractInfo *const*) metagen_con_active_general,
+	                        ac,
+	                        NULL);
+	dump_ip_configs (str,
+	                 nmc_config,
+	                 nm_active_connection_get_ip4_config (ac),
+	                 nm_active_connection_get_dhcp4_config (ac),
+	                 nm_active_connection_get_ip6_config (ac),
+	                 nm_active_connection_get_dhcp6_config (ac));
+	g_string_append_c (str, '}');
+}
+
+typedef void (*DumpObjectFunc) (GString *str, const NmcConfig *nmc_config, gpointer obj);
+
+static void
+dump_objects (GString *str,
+              const NmcConfig *nmc_config,
+              const char *name,
+              const GPtrArray *objects,
+              DumpObjectFunc dump_func,
+              gboolean *first)
+{
+	guint i;
+
+	/* Each object is serialized into @str and written out right away,
+	 * so that the memory use does not grow with the number of objects. */
+	g_print ("%s", *first ? "{" : ",");
+	*first = FALSE;
+
+	g_string_truncate (str, 0);
+	nmc_json_append_string (str, name);
+	g_print ("%s:[", str->str);
+
+	for (i = 0; objects && i < objects->len; i++) {
+		g_string_truncate (str, 0);
+		dump_func (str, nmc_config, objects->pdata[i]);
+		g_print ("%s\n%s", i > 0 ? "," : "", str->str);
+	}
+	g_print ("\n]");
+}
+
+static NMCResultCode
+do_general_dump (NmCli *nmc, int argc, char **argv)
+{
+	nm_auto_free_gstring GString *str = NULL;
+	gboolean dump_connections = FALSE;
+	gboolean dump_devices = FALSE;
+	gboolean dump_active = FALSE;
+	gboolean first = TRUE;
+
+	next_arg (nmc, &argc, &argv, NULL);
+	while (argc > 0) {
+		if (argc == 1 && nmc->complete)
+			nmc_complete_strings (*argv, "connections", "devices", "active", NULL);
+
+		if (matches (*argv, "connections"))
+			dump_connections = TRUE;
+		else if (matches (*argv, "devices"))
+			dump_devices = TRUE;
+		else if (matches (*argv, "active"))
+			dump_active = TRUE;
+		else {
+			g_string_printf (nmc->return_text, _("Error: invalid argument '%s'."), *argv);
+			return NMC_RESULT_ERROR_USER_INPUT;
+		}
+		next_arg (nmc, &argc, &argv, NULL);
+	}
+
+	if (nmc->complete)
+		return nmc->return_value;
+
+	if (!dump_connections && !dump_devices && !dump_active) {
+		dump_connections = TRUE;
+		dump_devices = TRUE;
+		dump_active = TRUE;
+	}
+
+	/* Everything is taken from the objects that NMClient already has
+	 * cached, so no further D-Bus requests are made per object. In particular,
+	 * secrets of connections are not requested and are always null. */
+	str = g_string_sized_new (4096);
+
+	if (dump_connections) {
+		dump_objects (str, &nmc->nmc_config, "connections",
+		              nm_client_get_connections (nmc->client),
+		              (DumpObjectFunc) dump_connection, &first);
+	}
+	if (dump_devices) {
+		dump_objects (str, &nmc->nmc_config, "devices",
+		              nm_client_get_devices (nmc->client),
+		              (DumpObjectFunc) dump_device, &first);
+	}
+	if (dump_active) {
+		dump_objects (str, &nmc->nmc_config, "active-connections",
+		              nm_client_get_active_connections (nmc->client),
+		              (DumpObjectFunc) dump_active_connection, &first);
+	}
+	g_print ("}\n");
+
+	return nmc->return_value;
+}
+
+static GVariant *
+debug_call (NmCli *nmc, const char *method_name, const char *reply_type)
+{
+	gs_unref_object GDBusConnection *dbus_connection = NULL;
+	gs_free_error GError *error = NULL;
+	GVariant *ret;
+
+	/* NMClient does not expose its D-Bus connection. Pick the bus the same way as libnm. */
+	dbus_connection = g_bus_get_sync (g_getenv ("LIBNM_USE_SESSION_BUS") ? G_BUS_TYPE_SESSION : G_BUS_TYPE_SYSTEM,
+	                                  NULL, &error);
+	if (dbus_connection) {
+		ret = g_dbus_connection_call_sync (dbus_connection,
+		                                   NM_DBUS_SERVICE,
+		                                   NM_DBUS_PATH,
+		                                   NM_DBUS_INTERFACE,
+		                                   method_name,
+		                                   NULL,
+		                                   G_VARIANT_TYPE (reply_type),
+		                                   G_DBUS_CALL_FLAGS_NONE,
+		                                   nmc->timeout > 0 ? nmc->timeout * 1000 : -1,
+		                                   NULL,
+		                                   &error);
+		if (ret)
+			return ret;
+	}
+
+	g_dbus_error_strip_remote_error (error);
+	g_string_printf (nmc->return_text, _("Error: failed to get statistics: %s"), error->message);
+	nmc->return_value = NMC_RESULT_ERROR_UNKNOWN;
+	return NULL;
+}
+
+static NMCResultCode
+do_general_debug (NmCli *nmc, int argc, char **argv)
+{
+	gs_unref_variant GVariant *ret = NULL;
+	gs_unref_ptrarray GPtrArray *v_buckets_keep = NULL;
+	gs_free gpointer *targets = NULL;
+	gs_free gpointer targets_data = NULL;
+	gs_free_error GError *error = NULL;
+	const NMMetaAbstractInfo *const*fields;
+	const char *fields_str = NULL;
+	const char *header_name;
+	GVariantIter *iter;
+	gsize n, i;
+	gboolean memory;
+
+	next_arg (nmc, &argc, &argv, NULL);
+
+	if (argc == 1 && nmc->complete)
+		nmc_complete_strings (*argv, "memory", "latency", NULL);
+
+	if (argc == 0) {
+		g_string_printf (nmc->return_text, _("Error: 'memory' or 'latency' argument is required."));
+		return NMC_RESULT_ERROR_USER_INPUT;
+	}
+	if (matches (*argv, "memory"))
+		memory = TRUE;
+	else if (matches (*argv, "latency"))
+		memory = FALSE;
+	else {
+		g_string_printf (nmc->return_text, _("Error: invalid argument '%s'."), *argv);
+		return NMC_RESULT_ERROR_USER_INPUT;
+	}
+	next_arg (nmc, &argc, &argv, NULL);
+	if (argc > 0) {
+		g_string_printf (nmc->return_text, _("Error: invalid extra argument '%s'."), *argv);
+		return NMC_RESULT_ERROR_USER_INPUT;
+	}
+
+	if (nmc->complete)
+		return nmc->return_value;
+
+	if (!nmc->required_fields || strcasecmp (nmc->required_fields, "common") == 0) {
+	} else if (strcasecmp (nmc->required_fields, "all") == 0) {
+	} else
+		fields_str = nmc->required_fields;
+
+	ret = debug_call (nmc,
+	                  memory ? "GetMemoryStats" : "GetLatencyStats",
+	                  memory ? "(a{su})" : "(a{s(tttat)})");
+	if (!ret)
+		return nmc->return_value;
+
+	g_variant_get (ret, memory ? "(a{su})" : "(a{s(tttat)})", &iter);
+	n = g_variant_iter_n_children (iter);
+	targets = g_new (gpointer, n + 1);
+	if (memory) {
+		DebugMemoryData *data = g_new (DebugMemoryData, n);
+
+		for (i = 0; g_variant_iter_next (iter, "{&su}", &data[i].name, &data[i].count); i++)
+			targets[i] = &data[i];
+		targets_data = data;
+		fields = (const NMMetaAbstractInfo *const*) metagen_general_debug_memory;
+		header_name = N_("NetworkManager memory statistics");
+	} else {
+		DebugLatencyData *data = g_new (DebugLatencyData, n);
+		GVariant *v_buckets;
+
+		v_buckets_keep = g_ptr_array_new_full (n, (GDestroyNotify) g_variant_unref);
+		for (i = 0; g_variant_iter_next (iter, "{&s(ttt@at)}",
+		                                 &data[i].name,
+		                                 &data[i].count,
+		                                 &data[i].total_ns,
+		                                 &data[i].max_ns,
+		                                 &v_buckets); i++) {
+			data[i].buckets = g_variant_get_fixed_array (v_buckets, &data[i].n_buckets, sizeof (guint64));
+			g_ptr_array_add (v_buckets_keep, v_buckets);
+			targets[i] = &data[i];
+		}
+		targets_data = data;
+		fields = (const NMMetaAbstractInfo *const*) metagen_general_debug_latency;
+		header_name = N_("NetworkManager latency statistics");
+	}
+	targets[i] = NULL;
+	g_variant_iter_free (iter);
+
+	if (!nmc_print (&nmc->nmc_config,
+	                targets,
+	                NULL,
+	                header_name,
+	                fields,
+	                fields_str,
+	                &error)) {
+		g_string_printf (nmc->return_text, _("Error: 'general debug': %s"), error->message);
+		nmc->return_value = NMC_RESULT_ERROR_USER_INPUT;
+	}
+
+	return nmc->return_value;
+}
+
 static const NMCCommand general_cmds[] = {
 	{ "status",       do_general_status,       usage_general_status,       TRUE,   TRUE },
 	{ "hostname",     do_general_hostname,     usage_general_hostname,     TRUE,   TRUE },
 	{ "permissions",  do_general_permissions,  usage_general_permissions,  TRUE,   TRUE },
 	{ "logging",      do_general_logging,      usage_general_logging,      TRUE,   TRUE },
+	{ "dump",         do_general_dump,         usage_general_dump,         TRUE,   TRUE },
+	{ "debug",        do_general_debug,        usage_general_debug,        TRUE,   TRUE },
 	{ NULL,           do_general_status,       usage_general,              TRUE,   TRUE },
 };
 
@@ -255,6 +255,8 @@ usage (void)
 	              "  -e[scape] yes|no                               escape columns separators in values\n"
 	              "  -a[sk]                                         ask for missing parameters\n"
 	              "  -s[how-secrets]                                allow displaying passwords\n"
+	              "  -st[ream]                                      print rows as they are produced\n"
+	              "  -b[atch] <file>|-                              run the commands in a file, one per line\n"
 	              "  -w[ait] <seconds>                              set timeout waiting for finishing operations\n"
 	              "  -v[ersion]                                     show program version\n"
 	              "  -h[elp]                                        print this help\n"
@@ -704,10 +706,109 @@ set_colors (NmcColorOption color_option,
 
 /*************************************************************************************/
 
+/**
+ * run_batch:
+ * @nmc: the #NmCli instance
+ * @filename: the file to read the commands from, or "-" for stdin
+ *
+ * Runs the commands read from @filename one after another, reusing the
+ * same NMClient instance. Each line contains one command as it would
+ * be passed to nmcli after the global options. Empty lines and lines
+ * starting with '#' are ignored. The result of each command is reported
+ * on stderr as soon as it completes.
+ */
+static void
+run_batch (NmCli *nmc, const char *filename)
+{
+	gs_unref_ptrarray GPtrArray *line_argvs = NULL;
+	const NmcConfig nmc_config = nmc->nmc_config;
+	char *required_fields = nmc->required_fields;
+	int timeout = nmc->timeout;
+	NMCResultCode result = NMC_RESULT_SUCCESS;
+	guint n_commands = 0;
+	guint n_failed = 0;
+	guint line_no = 0;
+	gs_free char *line = NULL;
+	size_t line_size = 0;
+	FILE *f;
+
+	if (nm_streq (filename, "-"))
+		f = stdin;
+	else {
+		f = fopen (filename, "re");
+		if (!f) {
+			g_string_printf (nmc->return_text, _("Error: failed to open '%s': %s."),
+			                 filename, g_strerror (errno));
+			nmc->return_value = NMC_RESULT_ERROR_USER_INPUT;
+			return;
+		}
+	}
+
+	/* The command handlers may still refer to their arguments from
+	 * asynchronous callbacks, keep all of them until we are done. */
+	line_argvs = g_ptr_array_new_with_free_func ((GDestroyNotify) g_strfreev);
+
+	while (getline (&line, &line_size, f) != -1) {
+		gs_free_error GError *error = NULL;
+		char **line_argv;
+		int line_argc;
+
+		line_no++;
+		g_strstrip (line);
+		if (NM_IN_SET (line[0], '\0', '#'))
+			continue;
+
+		n_commands++;
+
+		if (!g_shell_parse_argv (line, &line_argc, &line_argv, &error)) {
+			g_printerr (_("Line %u: Error: %s\n"), line_no, error->message);
+			if (result == NMC_RESULT_SUCCESS)
+				result = NMC_RESULT_ERROR_USER_INPUT;
+			n_failed++;
+			continue;
+		}
+		g_ptr_array_add (line_argvs, line_argv);
+
+		/* Commands adjust some of the global state to their needs, like
+		 * the timeout or the output mode. Start each one from the values
+		 * given on the command line. */
+		nmc->return_value = NMC_RESULT_SUCCESS;
+		g_string_assign (nmc->return_text, _("Success"));
+		nmc->should_wait = 0;
+		nmc->timeout = timeout;
+		nmc->required_fields = required_fields;
+		nmc->nmc_config_mutable = nmc_config;
+
+		nmc_do_cmd (nmc, nmcli_cmds, line_argv[0], line_argc, line_argv);
+		g_main_loop_run (loop);
+
+		g_printerr (_("Line %u: %s\n"), line_no, nmc->return_text->str);
+
+		if (nmc->return_value != NMC_RESULT_SUCCESS) {
+			if (result == NMC_RESULT_SUCCESS)
+				result = nmc->return_value;
+			n_failed++;
+			if (nmc->return_value == 0x80 + SIGINT)
+				break;
+		}
+	}
+
+	if (f != stdin)
+		fclose (f);
+
+	nmc->required_fields = required_fields;
+	nmc->return_value = result;
+	if (result != NMC_RESULT_SUCCESS) {
+		g_string_printf (nmc->return_text, _("Error: %u of %u commands failed."),
+		                 n_failed, n_commands);
+	}
+}
+
 static gboolean
 process_command_line (NmCli *nmc, int argc, char **argv)
 {
 	NmcColorOption colors = NMC_USE_COLOR_AUTO;
+	const char *batch_file = NULL;
 	char *base;
 
 	base = strrchr (argv[0], '/');
@@ -733,7 +834,7 @@ process_command_line (NmCli *nmc, int argc, char **argv)
 			nmc_complete_strings (argv[0], "--terse", "--pretty", "--mode", "--overview",
 			                               "--colors", "--escape",
 			                               "--fields", "--nocheck", "--get-values",
-			                               "--wait", "--version", "--help", NULL);
+			                               "--stream", "--batch", "--wait", "--version", "--help", NULL);
 		}
 
 		if (argv[0][1] == '-' && argv[0][2] == '\0') {
@@ -825,6 +926,12 @@ process_command_line (NmCli *nmc, int argc, char **argv)
 			nmc->mode_specified = TRUE;
 		} else if (matches_arg (nmc, &argc, &argv, "-nocheck", NULL)) {
 			/* ignore for backward compatibility */
+		} else if (matches_arg (nmc, &argc, &argv, "-stream", NULL)) {
+			nmc->nmc_config_mutable.stream = TRUE;
+		} else if (matches_arg (nmc, &argc, &argv, "-batch", &value)) {
+			if (argc == 1 && nmc->complete)
+				nmc->return_value = NMC_RESULT_COMPLETE_FILE;
+			batch_file = value;
 		} else if (matches_arg (nmc, &argc, &argv, "-wait", &value)) {
 			unsigned long timeout;
 
@@ -862,6 +969,18 @@ process_command_line (NmCli *nmc, int argc, char **argv)
 	            &nmc->palette_buffer,
 	            nmc->nmc_config_mutable.palette);
 
+	if (batch_file) {
+		if (nmc->complete)
+			return FALSE;
+		if (argc > 0) {
+			g_string_printf (nmc->return_text, _("Error: '--batch' cannot be combined with a command."));
+			nmc->return_value = NMC_RESULT_ERROR_USER_INPUT;
+			return FALSE;
+		}
+		run_batch (nmc, batch_file);
+		return FALSE;
+	}
+
 	/* Now run the requested command */
 	nmc_do_cmd (nmc, nmcli_cmds, *argv, argc, argv);
 
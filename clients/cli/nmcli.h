@@ -112,6 +112,7 @@ typedef struct _NmcConfig {
 	bool in_editor;                                   /* Whether running the editor - nmcli con edit' */
 	bool show_secrets;                                /* Whether to display secrets (both input and output): option '--show-secrets' */
 	bool overview;                                    /* Overview mode (hide default values) */
+	bool stream;                                      /* Print rows in chunks as they are produced: option '--stream' */
 	const char *palette[_NM_META_COLOR_NUM];          /* Color palette */
 } NmcConfig;
 
@@ -132,6 +132,10 @@ nmc_start_polkit_agent_start_try (NmCli *nmc)
 	if (!nmc->ask)
 		return TRUE;
 
+	/* Already registered, e.g. by a previous command in batch mode */
+	if (nmc->pk_listener)
+		return TRUE;
+
 	if (!nmc_polkit_agent_init (nmc, FALSE, &error)) {
 		g_printerr (_("Warning: polkit agent initialization failed: %s\n"),
 		            error->message);
@@ -923,6 +923,11 @@ nmc_empty_output_fields (NmcOutputData *output_data)
 
 /*****************************************************************************/
 
+/* number of rows that are filled and printed at once in stream mode.
+ * For tabular output, the first chunk is also the sample from which the
+ * column widths are estimated. */
+#define PRINT_STREAM_CHUNK_LEN 64
+
 typedef struct {
 	guint col_idx;
 	const PrintDataCol *col;
@@ -992,22 +997,13 @@ _print_data_cell_clear (gpointer cell_p)
 	_print_data_cell_clear_text (cell);
 }
 
-static void
-_print_fill (const NmcConfig *nmc_config,
-             gpointer const *targets,
-             gpointer targets_data,
-             const PrintDataCol *cols,
-             guint cols_len,
-             GArray **out_header_row,
-             GArray **out_cells)
+static GArray *
+_print_header_row_new (const NmcConfig *nmc_config,
+                       const PrintDataCol *cols,
+                       guint cols_len)
 {
-	GArray *cells;
 	GArray *header_row;
-	guint i_row, i_col;
-	guint targets_len;
-	NMMetaAccessorGetType text_get_type;
-	NMMetaAccessorGetFlags text_get_flags;
-
+	guint i_col;
 
 	header_row = g_array_sized_new (FALSE, TRUE, sizeof (PrintDataHeaderCell), cols_len);
 	g_array_set_clear_func (header_row, _print_data_header_cell_clear);
@@ -1049,7 +1045,20 @@ _print_fill (const NmcConfig *nmc_config,
 		}
 	}
 
-	targets_len = NM_PTRARRAY_LEN (targets);
+	return header_row;
+}
+
+static GArray *
+_print_fill (const NmcConfig *nmc_config,
+             gpointer const *targets,
+             guint targets_len,
+             gpointer targets_data,
+             GArray *header_row)
+{
+	GArray *cells;
+	guint i_row, i_col;
+	NMMetaAccessorGetType text_get_type;
+	NMMetaAccessorGetFlags text_get_flags;
 
 	cells = g_array_sized_new (FALSE, TRUE, sizeof (PrintDataCell), targets_len * header_row->len);
 	g_array_set_clear_func (cells, _print_data_cell_clear);
@@ -1148,13 +1157,25 @@ _print_fill (const NmcConfig *nmc_config,
 		}
 	}
 
+	return cells;
+}
+
+static void
+_print_calc_width (GArray *header_row,
+                   const GArray *cells)
+{
+	guint i_row, i_col;
+	guint rows_len;
+
+	rows_len = header_row->len > 0 ? cells->len / header_row->len : 0;
+
 	for (i_col = 0; i_col < header_row->len; i_col++) {
 		PrintDataHeaderCell *header_cell = &g_array_index (header_row, PrintDataHeaderCell, i_col);
 
 		header_cell->width = nmc_string_screen_width (header_cell->title, NULL);
 
-		for (i_row = 0; i_row < targets_len; i_row++) {
-			const PrintDataCell *cell = &g_array_index (cells, PrintDataCell, i_row * cols_len + i_col);
+		for (i_row = 0; i_row < rows_len; i_row++) {
+			const PrintDataCell *cell = &g_array_index (cells, PrintDataCell, i_row * header_row->len + i_col);
 			const char *const*i_strv;
 
 			switch (cell->text_format) {
@@ -1176,9 +1197,6 @@ _print_fill (const NmcConfig *nmc_config,
 
 		header_cell->width += 1;
 	}
-
-	*out_header_row = header_row;
-	*out_cells = cells;
 }
 
 static gboolean
@@ -1218,16 +1236,14 @@ _print_skip_column (const NmcConfig *nmc_config,
 }
 
 static void
-_print_do (const NmcConfig *nmc_config,
-           const char *header_name_no_l10n,
-           guint col_len,
-           guint row_len,
-           const PrintDataHeaderCell *header_row,
-           const PrintDataCell *cells)
+_print_do_header (const NmcConfig *nmc_config,
+                  const char *header_name_no_l10n,
+                  guint col_len,
+                  const PrintDataHeaderCell *header_row)
 {
 	int width1, width2;
 	int table_width = 0;
-	guint i_row, i_col;
+	guint i_col;
 	nm_auto_free_gstring GString *str = NULL;
 
 	g_assert (col_len);
@@ -1291,6 +1307,24 @@ _print_do (const NmcConfig *nmc_config,
 			g_print ("%s\n", (line = g_strnfill (table_width, '-')));
 		}
 	}
+}
+
+static void
+_print_do_rows (const NmcConfig *nmc_config,
+                guint col_len,
+                guint row_len,
+                const PrintDataHeaderCell *header_row,
+                const PrintDataCell *cells)
+{
+	int width1, width2;
+	guint i_row, i_col;
+	nm_auto_free_gstring GString *str = NULL;
+
+	g_assert (col_len);
+
+	str = !nmc_config->multiline_output
+	      ? g_string_sized_new (100)
+	      : NULL;
 
 	for (i_row = 0; i_row < row_len; i_row++) {
 		const PrintDataCell *current_line = &cells[i_row * col_len];
@@ -1358,7 +1392,6 @@ _print_do (const NmcConfig *nmc_config,
 						width2 = nmc_string_screen_width (text, NULL);  /* Width of the string (in screen columns) */
 						g_string_append_printf (str, "%-*s", (int) (header_cell->width + width1 - width2), text);
 						g_string_append_c (str, ' ');  /* Column separator */
-						table_width += header_cell->width + width1 - width2 + 1;
 					}
 				}
 			}
@@ -1393,33 +1426,214 @@ nmc_print (const NmcConfig *nmc_config,
 	gs_unref_ptrarray GPtrArray *gfree_keeper = NULL;
 	gs_unref_array GArray *cols = NULL;
 	gs_unref_array GArray *header_row = NULL;
-	gs_unref_array GArray *cells = NULL;
+	guint targets_len;
+	guint i_row, i_col;
 
 	if (!_output_selection_parse (fields, fields_str,
 	                              &cols, &gfree_keeper,
 	                              error))
 		return FALSE;
 
-	_print_fill (nmc_config,
-	             targets,
-	             targets_data,
-	             &g_array_index (cols, PrintDataCol, 0),
-	             cols->len,
-	             &header_row,
-	             &cells);
-
-	_print_do (nmc_config,
-	           header_name_no_l10n,
-	           header_row->len,
-	           cells->len / header_row->len,
-	           &g_array_index (header_row, PrintDataHeaderCell, 0),
-	           &g_array_index (cells, PrintDataCell, 0));
+	header_row = _print_header_row_new (nmc_config,
+	                                    &g_array_index (cols, PrintDataCol, 0),
+	                                    cols->len);
+
+	targets_len = NM_PTRARRAY_LEN (targets);
+
+	if (!nmc_config->stream) {
+		gs_unref_array GArray *cells = NULL;
+
+		cells = _print_fill (nmc_config,
+		                     targets,
+		                     targets_len,
+		                     targets_data,
+		                     header_row);
+		_print_calc_width (header_row, cells);
+
+		_print_do_header (nmc_config,
+		                  header_name_no_l10n,
+		                  header_row->len,
+		                  &g_array_index (header_row, PrintDataHeaderCell, 0));
+		_print_do_rows (nmc_config,
+		                header_row->len,
+		                targets_len,
+		                &g_array_index (header_row, PrintDataHeaderCell, 0),
+		                &g_array_index (cells, PrintDataCell, 0));
+		return TRUE;
+	}
+
+	/* In stream mode, rows are filled and printed in chunks of at most
+	 * PRINT_STREAM_CHUNK_LEN rows, so that the output starts right away and
+	 * we don't keep the cells of all rows in memory at once.
+	 *
+	 * The column widths for the tabular output are estimated from the
+	 * first chunk only. Longer values of later rows are still printed
+	 * in full, they just don't line up.
+	 *
+	 * Likewise, in tabular output the set of columns is fixed once the header
+	 * is printed, so columns with default values cannot be hidden. In
+	 * multiline output each row is printed on its own, so hiding is decided
+	 * per chunk. */
+	i_row = 0;
+	do {
+		gs_unref_array GArray *cells = NULL;
+		guint chunk_len;
+
+		chunk_len = NM_MIN (targets_len - i_row, PRINT_STREAM_CHUNK_LEN);
+
+		for (i_col = 0; i_col < header_row->len; i_col++) {
+			g_array_index (header_row, PrintDataHeaderCell, i_col).to_print = !nmc_config->multiline_output;
+		}
+
+		cells = _print_fill (nmc_config,
+		                     targets ? &targets[i_row] : NULL,
+		                     chunk_len,
+		                     targets_data,
+		                     header_row);
+
+		if (i_row == 0) {
+			_print_calc_width (header_row, cells);
+			_print_do_header (nmc_config,
+			                  header_name_no_l10n,
+			                  header_row->len,
+			                  &g_array_index (header_row, PrintDataHeaderCell, 0));
+		}
+
+		_print_do_rows (nmc_config,
+		                header_row->len,
+		                chunk_len,
+		                &g_array_index (header_row, PrintDataHeaderCell, 0),
+		                &g_array_index (cells, PrintDataCell, 0));
+		fflush (stdout);
+
+		i_row += chunk_len;
+	} while (i_row < targets_len);
 
 	return TRUE;
 }
 
 /*****************************************************************************/
 
+void
+nmc_json_append_string (GString *str, const char *value)
+{
+	const char *p;
+
+	if (!value) {
+		g_string_append (str, "null");
+		return;
+	}
+
+	g_string_append_c (str, '"');
+	for (p = value; *p; p++) {
+		switch (*p) {
+		case '"':
+			g_string_append (str, "\\\"");
+			break;
+		case '\\':
+			g_string_append (str, "\\\\");
+			break;
+		case '\n':
+			g_string_append (str, "\\n");
+			break;
+		case '\r':
+			g_string_append (str, "\\r");
+			break;
+		case '\t':
+			g_string_append (str, "\\t");
+			break;
+		default:
+			if ((guchar) *p < 0x20)
+				g_string_append_printf (str, "\\u%04x", (guint) (guchar) *p);
+			else
+				g_string_append_c (str, *p);
+			break;
+		}
+	}
+	g_string_append_c (str, '"');
+}
+
+/**
+ * nmc_json_append_fields:
+ * @str: the string to append to
+ * @nmc_config: the configuration. Only show_secrets is honored.
+ * @fields: %NULL terminated list of meta infos to serialize
+ * @target: the object to serialize
+ * @target_data: extra data passed to the getters
+ *
+ * Appends a JSON object with one member per field in @fields. The
+ * member names are the names of the meta infos, the values are their
+ * parsable representation. Array values become JSON arrays of strings,
+ * unset values and hidden secrets become null.
+ */
+void
+nmc_json_append_fields (GString *str,
+                        const NmcConfig *nmc_config,
+                        const NMMetaAbstractInfo *const*fields,
+                        gpointer target,
+                        gpointer target_data)
+{
+	NMMetaAccessorGetFlags get_flags;
+	guint i, j;
+
+	get_flags = NM_META_ACCESSOR_GET_FLAGS_ACCEPT_STRV;
+	if (nmc_config->show_secrets)
+		get_flags |= NM_META_ACCESSOR_GET_FLAGS_SHOW_SECRETS;
+
+	g_string_append_c (str, '{');
+	for (i = 0; fields && fields[i]; i++) {
+		const NMMetaAbstractInfo *info = fields[i];
+		NMMetaAccessorGetOutFlags out_flags;
+		gpointer to_free = NULL;
+		gconstpointer value;
+		gboolean is_default;
+
+		if (i > 0)
+			g_string_append_c (str, ',');
+		nmc_json_append_string (str, nm_meta_abstract_info_get_name (info, FALSE));
+		g_string_append_c (str, ':');
+
+		if (   info->meta_type == &nm_meta_type_property_info
+		    && ((const NMMetaPropertyInfo *) info)->is_secret
+		    && !nmc_config->show_secrets) {
+			g_string_append (str, "null");
+			continue;
+		}
+
+		value = nm_meta_abstract_info_get (info,
+		                                   nmc_meta_environment,
+		                                   nmc_meta_environment_arg,
+		                                   target,
+		                                   target_data,
+		                                   NM_META_ACCESSOR_GET_TYPE_PARSABLE,
+		                                   get_flags,
+		                                   &out_flags,
+		                                   &is_default,
+		                                   &to_free);
+
+		nm_assert (!to_free || value == to_free);
+
+		if (NM_FLAGS_HAS (out_flags, NM_META_ACCESSOR_GET_OUT_FLAGS_STRV)) {
+			const char *const*strv = value;
+
+			g_string_append_c (str, '[');
+			for (j = 0; strv && strv[j]; j++) {
+				if (j > 0)
+					g_string_append_c (str, ',');
+				nmc_json_append_string (str, strv[j]);
+			}
+			g_string_append_c (str, ']');
+			g_strfreev (to_free);
+		} else {
+			nmc_json_append_string (str, value);
+			g_free (to_free);
+		}
+	}
+	g_string_append_c (str, '}');
+}
+
+/*****************************************************************************/
+
 static void
 pager_fallback (void)
 {
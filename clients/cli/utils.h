@@ -106,6 +106,19 @@ typedef enum {
 	NMC_GENERIC_INFO_TYPE_GENERAL_LOGGING_DOMAINS,
 	_NMC_GENERIC_INFO_TYPE_GENERAL_LOGGING_NUM,
 
+	NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_MEMORY_NAME = 0,
+	NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_MEMORY_COUNT,
+	_NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_MEMORY_NUM,
+
+	NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_OPERATION = 0,
+	NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_COUNT,
+	NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_AVG,
+	NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_P50,
+	NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_P90,
+	NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_P99,
+	NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_MAX,
+	_NMC_GENERIC_INFO_TYPE_GENERAL_DEBUG_LATENCY_NUM,
+
 	NMC_GENERIC_INFO_TYPE_IP4_CONFIG_ADDRESS = 0,
 	NMC_GENERIC_INFO_TYPE_IP4_CONFIG_GATEWAY,
 	NMC_GENERIC_INFO_TYPE_IP4_CONFIG_ROUTE,
@@ -344,6 +357,13 @@ gboolean nmc_print (const NmcConfig *nmc_config,
                     const char *fields_str,
                     GError **error);
 
+void nmc_json_append_string (GString *str, const char *value);
+void nmc_json_append_fields (GString *str,
+                             const NmcConfig *nmc_config,
+                             const NMMetaAbstractInfo *const*fields,
+                             gpointer target,
+                             gpointer target_data);
+
 /*****************************************************************************/
 
 #endif /* NMC_UTILS_H */
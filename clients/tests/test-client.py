@@ -83,7 +83,9 @@ import socket
 import itertools
 import subprocess
 import shlex
+import tempfile
 import re
+import json
 import dbus
 import time
 import dbus.service
@@ -485,6 +487,7 @@ class TestNmcli(NmTestBase):
                              replace_stdout,
                              replace_stderr,
                              sort_lines_stdout,
+                             None,
                              extra_env,
                              sync_barrier,
                              frame)
@@ -502,6 +505,7 @@ class TestNmcli(NmTestBase):
                    replace_stdout = None,
                    replace_stderr = None,
                    sort_lines_stdout = False,
+                   check_stdout = None,
                    extra_env = None,
                    sync_barrier = None):
 
@@ -528,6 +532,7 @@ class TestNmcli(NmTestBase):
                              replace_stdout,
                              replace_stderr,
                              sort_lines_stdout,
+                             check_stdout,
                              extra_env,
                              sync_barrier,
                              frame)
@@ -543,6 +548,7 @@ class TestNmcli(NmTestBase):
                     replace_stdout,
                     replace_stderr,
                     sort_lines_stdout,
+                    check_stdout,
                     extra_env,
                     sync_barrier,
                     frame):
@@ -629,6 +635,9 @@ class TestNmcli(NmTestBase):
             if sort_lines_stdout:
                 stdout = b'\n'.join(sorted(stdout.split(b'\n')))
 
+            if check_stdout is not None:
+                check_stdout(stdout)
+
             ignore_l10n_diff = (    lang != 'C'
                                 and not conf.get(ENV_NM_TEST_CLIENT_CHECK_L10N))
 
@@ -1075,6 +1084,117 @@ class TestNmcli(NmTestBase):
             self.call_nmcli_l(mode + ['-f', 'GENERAL,CAPABILITIES,WIFI-PROPERTIES,AP,WIRED-PROPERTIES,WIMAX-PROPERTIES,NSP,IP4,DHCP4,IP6,DHCP6,BOND,TEAM,BRIDGE,VLAN,BLUETOOTH,CONNECTIONS', 'device', 'show', 'wlan0' ],
                               replace_stdout = replace_stdout)
 
+    @nm_test
+    def test_005(self):
+        self.init_001()
+
+        # run several activations in one nmcli process. Each command must
+        # clean up its timeout and signal handlers, before the next one
+        # reuses the same main loop.
+        with tempfile.NamedTemporaryFile(mode = 'w', suffix = '.nmcli') as batch_file:
+            batch_file.write('con up con-1 ifname eth0\n')
+            batch_file.write('con up con-1 ifname eth1\n')
+            batch_file.flush()
+
+            self.call_nmcli(['--batch', batch_file.name],
+                            expected_returncode = 0,
+                            expected_stdout = ('Connection successfully activated (D-Bus active path: /org/freedesktop/NetworkManager/ActiveConnection/1)\n'
+                                               'Connection successfully activated (D-Bus active path: /org/freedesktop/NetworkManager/ActiveConnection/2)\n').encode('utf-8'),
+                            expected_stderr = ('Line 1: Success\n'
+                                               'Line 2: Success\n').encode('utf-8'))
+
+        self.call_nmcli(['-t', '-f', 'NAME,DEVICE', 'con', 's', '--active'],
+                        sort_lines_stdout = True)
+
+    @nm_test
+    def test_006(self):
+        self.init_001()
+
+        self.call_nmcli(['general', 'debug', 'latency'])
+
+        self.call_nmcli(['-t', 'general', 'debug', 'latency'],
+                        expected_returncode = 0,
+                        expected_stdout = ('netlink-event:4:11125:2048:40000:40000:40000\n'
+                                           'dns-update:1:3000000:3000000:3000000:3000000:3000000\n'
+                                           'settings-write:0:::::\n').encode('utf-8'))
+
+        self.call_nmcli(['-t', '-f', 'NAME,COUNT', 'general', 'debug', 'memory'])
+
+        self.call_nmcli(['-m', 'multiline', '-f', 'OPERATION,COUNT,P99', 'general', 'debug', 'latency'])
+
+    @nm_test
+    def test_007(self):
+        # --stream prints the rows in chunks of 64. Add more connections than
+        # that, with names of the same length, so that the column widths taken
+        # from the first chunk fit all rows and the output is the same as
+        # without --stream.
+        names = ['stream-%02d' % (i) for i in range(70)]
+        for name in names:
+            self.srv.addConnection( {
+                                        'connection': {
+                                            'type': '802-3-ethernet',
+                                            'id':   name,
+                                        },
+                                    })
+
+        expected_stdout = ''.join(['%s\n' % (name) for name in names]).encode('utf-8')
+        for mode in [[], ['--stream']]:
+            self.call_nmcli(mode + ['-t', '-f', 'NAME', 'c'],
+                            expected_returncode = 0,
+                            expected_stdout = expected_stdout)
+
+        expected_stdout = (  ('%-10s %-9s\n' % ('NAME', 'TYPE'))
+                           + ''.join(['%-10s %-9s\n' % (name, 'ethernet') for name in names])).encode('utf-8')
+        for mode in [[], ['--stream']]:
+            self.call_nmcli(mode + ['-f', 'NAME,TYPE', 'c'],
+                            expected_returncode = 0,
+                            expected_stdout = expected_stdout)
+
+        self.call_nmcli(['--stream', '-m', 'multiline', '-f', 'NAME,TYPE', 'c'])
+
+    @nm_test
+    def test_008(self):
+        self.init_001()
+
+        self.call_nmcli(['con', 'up', 'con-1', 'ifname', 'eth0'],
+                        expected_returncode = 0,
+                        expected_stdout = 'Connection successfully activated (D-Bus active path: /org/freedesktop/NetworkManager/ActiveConnection/1)\n'.encode('utf-8'))
+
+        def check_dump(stdout):
+            dump = json.loads(stdout.decode('utf-8'))
+            self.assertEqual(sorted(dump.keys()), ['active-connections', 'connections', 'devices'])
+
+            self.assertEqual(len(dump['connections']), 1)
+            settings = dump['connections'][0]['settings']
+            self.assertEqual(settings['connection']['id'], 'con-1')
+            self.assertEqual(settings['connection']['type'], '802-3-ethernet')
+
+            self.assertEqual(sorted([d['GENERAL']['DEVICE'] for d in dump['devices']]),
+                             ['eth0', 'eth1', 'wlan0', 'wlan1', 'wlan1'])
+            for d in dump['devices']:
+                self.assertEqual(sorted(d.keys()), ['DHCP4', 'DHCP6', 'GENERAL', 'IP4', 'IP6', 'path'])
+
+            self.assertEqual(len(dump['active-connections']), 1)
+            ac = dump['active-connections'][0]
+            self.assertEqual(ac['path'], '/org/freedesktop/NetworkManager/ActiveConnection/1')
+            self.assertEqual(ac['GENERAL']['NAME'], 'con-1')
+            self.assertEqual(ac['GENERAL']['DEVICES'], 'eth0')
+
+        self.call_nmcli(['general', 'dump'],
+                        expected_returncode = 0,
+                        check_stdout = check_dump)
+
+        def check_dump_devices(stdout):
+            dump = json.loads(stdout.decode('utf-8'))
+            self.assertEqual(list(dump.keys()), ['devices'])
+            self.assertEqual(len(dump['devices']), 5)
+
+        self.call_nmcli(['general', 'dump', 'devices'],
+                        expected_returncode = 0,
+                        check_stdout = check_dump_devices)
+
+        self.call_nmcli(['general', 'dump', 'bogus'])
+
 ###############################################################################
 
 def main():
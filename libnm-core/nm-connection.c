@@ -568,8 +568,11 @@ diff_one_connection (NMConnection *a,
 		GHashTable *results;
 		gboolean new_results = TRUE;
 
-		if (b)
+		if (b) {
 			b_setting = nm_connection_get_setting (b, G_OBJECT_TYPE (a_setting));
+			if (b_setting == a_setting)
+				continue;
+		}
 
 		results = g_hash_table_lookup (diffs, setting_name);
 		if (results)
@@ -2506,29 +2506,32 @@ _parse_info_find (NMSetting *setting,
 /*****************************************************************************/
 
 static void
-read_one_setting_value (NMSetting *setting,
-                        const char *key,
-                        const GValue *value,
-                        GParamFlags flags,
-                        gpointer user_data)
+read_one_setting_value (KeyfileReaderInfo *info,
+                        NMSetting *setting,
+                        const char *setting_name,
+                        GParamSpec *pspec,
+                        const ParseInfoProperty *pip)
 {
-	KeyfileReaderInfo *info = user_data;
 	GKeyFile *keyfile = info->keyfile;
-	const char *setting_name;
+	const char *key = pspec->name;
 	int errsv;
 	GType type;
 	gs_free_error GError *err = NULL;
-	const ParseInfoProperty *pip;
 
 	if (info->error)
 		return;
 
-	if (!(flags & G_PARAM_WRITABLE))
+	if (!(pspec->flags & G_PARAM_WRITABLE))
 		return;
 
-	pip = _parse_info_find (setting, key, &setting_name);
+#if NM_MORE_ASSERTS > 5
+	{
+		const char *setting_name2;
 
-	nm_assert (setting_name);
+		nm_assert (pip == _parse_info_find (setting, key, &setting_name2));
+		nm_assert (nm_streq0 (setting_name, setting_name2));
+	}
+#endif
 
 	if (   !pip
 	    && nm_streq (key, NM_SETTING_NAME))
@@ -2559,7 +2562,7 @@ read_one_setting_value (NMSetting *setting,
 		return;
 	}
 
-	type = G_VALUE_TYPE (value);
+	type = G_PARAM_SPEC_VALUE_TYPE (pspec);
 
 	if (type == G_TYPE_STRING) {
 		gs_free char *str_val = NULL;
@@ -2664,7 +2667,7 @@ read_one_setting_value (NMSetting *setting,
 		read_hash_of_string (keyfile, setting, key);
 	} else if (type == G_TYPE_ARRAY) {
 		read_array_of_uint (keyfile, setting, key);
-	} else if (G_VALUE_HOLDS_FLAGS (value)) {
+	} else if (G_TYPE_IS_FLAGS (type)) {
 		guint64 uint_val;
 
 		/* Flags are guint but GKeyFile has no uint reader, just uint64 */
@@ -2675,11 +2678,11 @@ read_one_setting_value (NMSetting *setting,
 			else {
 				if (!handle_warn (info, key, NM_KEYFILE_WARN_SEVERITY_WARN,
 				                  _("too large FLAGS property '%s' (%llu)"),
-				                  G_VALUE_TYPE_NAME (value), (unsigned long long) uint_val))
+				                  g_type_name (type), (unsigned long long) uint_val))
 					return;
 			}
 		}
-	} else if (G_VALUE_HOLDS_ENUM (value)) {
+	} else if (G_TYPE_IS_ENUM (type)) {
 		int int_val;
 
 		int_val = nm_keyfile_plugin_kf_get_integer (keyfile, setting_name, key, &err);
@@ -2688,7 +2691,7 @@ read_one_setting_value (NMSetting *setting,
 	} else {
 		if (!handle_warn (info, key, NM_KEYFILE_WARN_SEVERITY_WARN,
 		                 _("unhandled setting property type '%s'"),
-		                 G_VALUE_TYPE_NAME (value)))
+		                 g_type_name (type)))
 			return;
 	}
 }
@@ -2784,8 +2787,44 @@ read_setting (KeyfileReaderInfo *info)
 			for (; i < n_keys; i++)
 				g_free (keys[i]);
 		}
-	} else
-		nm_setting_enumerate_values (setting, read_one_setting_value, info);
+	} else {
+		const ParseInfoSetting *pis;
+		const ParseInfoProperty *const*pip_iter = NULL;
+		const char *setting_name;
+		guint i;
+
+		/* Don't use nm_setting_enumerate_values(), which would get a copy of every
+		 * property value, only to find that most keys are not present in the keyfile.
+		 *
+		 * Both the property infos and the parse infos are sorted by name, so
+		 * we find the parse info for each property by walking them in lockstep,
+		 * instead of looking it up via binary search. */
+		setting_name = sett_info->setting_class->setting_info->setting_name;
+		pis = parse_infos[sett_info->setting_class->setting_info->meta_type];
+		if (pis)
+			pip_iter = pis->properties;
+
+		for (i = 0; i < sett_info->property_infos_len; i++) {
+			const NMSettInfoProperty *property_info = &sett_info->property_infos[i];
+			const ParseInfoProperty *pip = NULL;
+
+			if (!property_info->param_spec)
+				continue;
+
+			if (pip_iter) {
+				while (   *pip_iter
+				       && strcmp ((*pip_iter)->property_name, property_info->name) < 0)
+					pip_iter++;
+				if (   *pip_iter
+				    && nm_streq ((*pip_iter)->property_name, property_info->name))
+					pip = *pip_iter;
+			}
+
+			read_one_setting_value (info, setting, setting_name, property_info->param_spec, pip);
+			if (info->error)
+				break;
+		}
+	}
 
 	info->setting = NULL;
 
@@ -969,17 +969,6 @@ _nm_setting_get_property (NMSetting *setting, const char *property_name, GValue
 	return TRUE;
 }
 
-static void
-duplicate_setting (NMSetting *setting,
-                   const char *name,
-                   const GValue *value,
-                   GParamFlags flags,
-                   gpointer user_data)
-{
-	if ((flags & (G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY)) == G_PARAM_WRITABLE)
-		g_object_set_property (G_OBJECT (user_data), name, value);
-}
-
 /**
  * nm_setting_duplicate:
  * @setting: the #NMSetting to duplicate
@@ -1019,8 +1008,31 @@ nm_setting_duplicate (NMSetting *setting)
 			}
 		}
 	} else {
+		guint i;
+
+		/* Iterate the (already sorted) property infos directly instead of going
+		 * through nm_setting_enumerate_values(). That would fetch and sort the
+		 * list of GParamSpecs for every copy, which is expensive when cloning
+		 * many connections. Note that the properties are set strictly sorted
+		 * by name. Unlike nm_setting_enumerate_values(), that does not put
+		 * id, uuid and type of NMSettingConnection first. Setters that derive
+		 * other properties (like NMSettingTeam's config) are therefore still
+		 * called in the same order as before, and the setters of id, uuid
+		 * and type only store the value. */
 		g_object_freeze_notify (dup);
-		nm_setting_enumerate_values (setting, duplicate_setting, dup);
+		for (i = 0; i < sett_info->property_infos_len; i++) {
+			GParamSpec *prop_spec = sett_info->property_infos[i].param_spec;
+			GValue value = G_VALUE_INIT;
+
+			if (   !prop_spec
+			    || (prop_spec->flags & (G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY)) != G_PARAM_WRITABLE)
+				continue;
+
+			g_value_init (&value, G_PARAM_SPEC_VALUE_TYPE (prop_spec));
+			g_object_get_property (G_OBJECT (setting), prop_spec->name, &value);
+			g_object_set_property (dup, prop_spec->name, &value);
+			g_value_unset (&value);
+		}
 		g_object_thaw_notify (dup);
 	}
 	return NM_SETTING (dup);
@@ -1131,6 +1143,54 @@ _nm_setting_verify_secret_string (const char *str,
 	return TRUE;
 }
 
+/* Compare the native values of properties with simple types directly,
+ * without converting them to GVariant first. This only works for properties
+ * that use the default D-Bus conversion of their GValue, which for these types
+ * preserves (in)equality. Returns %FALSE if the property is not eligible, in
+ * which case @out_same is not touched. */
+static gboolean
+_compare_property_native (NMSetting *setting,
+                          NMSetting *other,
+                          const NMSettInfoProperty *property,
+                          gboolean *out_same)
+{
+	GParamSpec *prop_spec = property->param_spec;
+	GValue value1 = G_VALUE_INIT;
+	GValue value2 = G_VALUE_INIT;
+
+	if (   !prop_spec
+	    || property->get_func
+	    || property->to_dbus)
+		return FALSE;
+
+	switch (G_TYPE_FUNDAMENTAL (prop_spec->value_type)) {
+	case G_TYPE_BOOLEAN:
+	case G_TYPE_CHAR:
+	case G_TYPE_UCHAR:
+	case G_TYPE_INT:
+	case G_TYPE_UINT:
+	case G_TYPE_INT64:
+	case G_TYPE_UINT64:
+	case G_TYPE_ENUM:
+	case G_TYPE_FLAGS:
+	case G_TYPE_STRING:
+		break;
+	default:
+		return FALSE;
+	}
+
+	g_value_init (&value1, prop_spec->value_type);
+	g_value_init (&value2, prop_spec->value_type);
+	g_object_get_property (G_OBJECT (setting), prop_spec->name, &value1);
+	g_object_get_property (G_OBJECT (other), prop_spec->name, &value2);
+
+	*out_same = (g_param_values_cmp (prop_spec, &value1, &value2) == 0);
+
+	g_value_unset (&value1);
+	g_value_unset (&value2);
+	return TRUE;
+}
+
 static gboolean
 compare_property (NMSetting *setting,
                   NMSetting *other,
@@ -1139,6 +1199,7 @@ compare_property (NMSetting *setting,
 {
 	const NMSettInfoProperty *property;
 	GVariant *value1, *value2;
+	gboolean same;
 	int cmp;
 
 	/* Handle compare flags */
@@ -1172,6 +1233,9 @@ compare_property (NMSetting *setting,
 	property = _nm_sett_info_property_get (NM_SETTING_GET_CLASS (setting), prop_spec->name);
 	g_return_val_if_fail (property != NULL, FALSE);
 
+	if (_compare_property_native (setting, other, property, &same))
+		return same;
+
 	value1 = get_property_for_dbus (setting, property, TRUE);
 	value2 = get_property_for_dbus (other, property, TRUE);
 
@@ -1203,14 +1267,15 @@ nm_setting_compare (NMSetting *a,
                     NMSettingCompareFlags flags)
 {
 	const NMSettInfoSetting *sett_info;
-	GParamSpec **property_specs;
-	guint n_property_specs;
 	int same = TRUE;
 	guint i;
 
 	g_return_val_if_fail (NM_IS_SETTING (a), FALSE);
 	g_return_val_if_fail (NM_IS_SETTING (b), FALSE);
 
+	if (a == b)
+		return TRUE;
+
 	/* First check that both have the same type */
 	if (G_OBJECT_TYPE (a) != G_OBJECT_TYPE (b))
 		return FALSE;
@@ -1227,10 +1292,13 @@ nm_setting_compare (NMSetting *a,
 		                                  g_variant_equal);
 	}
 
-	/* And now all properties */
-	property_specs = g_object_class_list_properties (G_OBJECT_GET_CLASS (a), &n_property_specs);
-	for (i = 0; i < n_property_specs && same; i++) {
-		GParamSpec *prop_spec = property_specs[i];
+	/* And now all properties. The property infos contain all GObject
+	 * properties of the class, no need to list (and allocate) them again. */
+	for (i = 0; i < sett_info->property_infos_len && same; i++) {
+		GParamSpec *prop_spec = sett_info->property_infos[i].param_spec;
+
+		if (!prop_spec)
+			continue;
 
 		/* Fuzzy compare ignores secrets and properties defined with the FUZZY_IGNORE flag */
 		if (   NM_FLAGS_HAS (flags, NM_SETTING_COMPARE_FLAG_FUZZY)
@@ -1251,7 +1319,6 @@ nm_setting_compare (NMSetting *a,
 
 		same = NM_SETTING_GET_CLASS (a)->compare_property (a, b, prop_spec, flags);
 	}
-	g_free (property_specs);
 
 	return same;
 }
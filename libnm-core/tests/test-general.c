@@ -2486,6 +2486,36 @@ test_connection_compare_same (void)
 	g_object_unref (b);
 }
 
+static void
+test_setting_duplicate (void)
+{
+	gs_unref_object NMConnection *con = NULL;
+	NMMetaSettingType meta_type;
+
+	con = new_test_connection ();
+
+	for (meta_type = 0; meta_type < _NM_META_SETTING_TYPE_NUM; meta_type++) {
+		const NMMetaSettingInfo *info = &nm_meta_setting_infos[meta_type];
+		gs_unref_object NMSetting *s_new = NULL;
+		gs_unref_object NMSetting *s_dup = NULL;
+		NMSetting *s_con;
+
+		s_new = g_object_new (info->get_setting_gtype (), NULL);
+		s_dup = nm_setting_duplicate (s_new);
+		g_assert (s_dup != s_new);
+		g_assert (G_OBJECT_TYPE (s_dup) == G_OBJECT_TYPE (s_new));
+		g_assert (nm_setting_compare (s_new, s_dup, NM_SETTING_COMPARE_FLAG_EXACT));
+		g_assert (nm_setting_compare (s_new, s_new, NM_SETTING_COMPARE_FLAG_EXACT));
+
+		s_con = nm_connection_get_setting_by_name (con, info->setting_name);
+		if (s_con) {
+			g_clear_object (&s_dup);
+			s_dup = nm_setting_duplicate (s_con);
+			g_assert (nm_setting_compare (s_con, s_dup, NM_SETTING_COMPARE_FLAG_EXACT));
+		}
+	}
+}
+
 static void
 test_connection_compare_key_only_in_a (void)
 {
@@ -7322,6 +7352,7 @@ int main (int argc, char **argv)
 	g_test_add_func ("/core/general/test_setting_connection_permissions_property", test_setting_connection_permissions_property);
 
 	g_test_add_func ("/core/general/test_connection_compare_same", test_connection_compare_same);
+	g_test_add_func ("/core/general/test_setting_duplicate", test_setting_duplicate);
 	g_test_add_func ("/core/general/test_connection_compare_key_only_in_a", test_connection_compare_key_only_in_a);
 	g_test_add_func ("/core/general/test_connection_compare_setting_only_in_a", test_connection_compare_setting_only_in_a);
 	g_test_add_func ("/core/general/test_connection_compare_key_only_in_b", test_connection_compare_key_only_in_b);
@@ -26,6 +26,8 @@
 #include "nm-simple-connection.h"
 #include "nm-setting-connection.h"
 #include "nm-setting-wired.h"
+#include "nm-setting-ip4-config.h"
+#include "nm-setting-ip6-config.h"
 #include "nm-setting-8021x.h"
 #include "nm-setting-team.h"
 #include "nm-setting-user.h"
@@ -736,6 +738,95 @@ test_vpn_1 (void)
 
 /*****************************************************************************/
 
+#define _READ_1_KEYFILE \
+	"[connection]\n" \
+	"id=read-1\n" \
+	"uuid=a5f3a0e0-4c4a-4a45-9b1f-7e0c4a1d1d2a\n" \
+	"type=ethernet\n" \
+	"interface-name=eth0\n" \
+	"autoconnect=false\n" \
+	"autoconnect-priority=-5\n" \
+	"\n" \
+	"[ethernet]\n" \
+	"mac-address=00:11:22:33:44:55\n" \
+	"mtu=1400\n" \
+	"\n" \
+	"[ipv4]\n" \
+	"method=manual\n" \
+	"address1=192.168.1.5/24,192.168.1.1\n" \
+	"dns=8.8.8.8;\n" \
+	"dns-search=example.com;\n" \
+	"route-metric=50\n" \
+	"\n" \
+	"[ipv6]\n" \
+	"method=auto\n" \
+	"addr-gen-mode=stable-privacy\n" \
+	"ip6-privacy=2\n" \
+	""
+
+static void
+test_read_1 (void)
+{
+	gs_unref_keyfile GKeyFile *keyfile = NULL;
+	gs_unref_object NMConnection *con = NULL;
+	NMSettingConnection *s_con;
+	NMSettingWired *s_wired;
+	NMSettingIPConfig *s_ip4;
+	NMSettingIPConfig *s_ip6;
+	GError *error = NULL;
+	guint i, n;
+
+	con = nmtst_create_connection_from_keyfile (_READ_1_KEYFILE, "/test_read_1", NULL);
+
+	s_con = nm_connection_get_setting_connection (con);
+	g_assert (s_con);
+	g_assert_cmpstr (nm_setting_connection_get_id (s_con), ==, "read-1");
+	g_assert_cmpstr (nm_setting_connection_get_interface_name (s_con), ==, "eth0");
+	g_assert (!nm_setting_connection_get_autoconnect (s_con));
+	g_assert_cmpint (nm_setting_connection_get_autoconnect_priority (s_con), ==, -5);
+
+	s_wired = nm_connection_get_setting_wired (con);
+	g_assert (s_wired);
+	g_assert_cmpstr (nm_setting_wired_get_mac_address (s_wired), ==, "00:11:22:33:44:55");
+	g_assert_cmpint (nm_setting_wired_get_mtu (s_wired), ==, 1400);
+
+	s_ip4 = nm_connection_get_setting_ip4_config (con);
+	g_assert (s_ip4);
+	g_assert_cmpstr (nm_setting_ip_config_get_method (s_ip4), ==, NM_SETTING_IP4_CONFIG_METHOD_MANUAL);
+	g_assert_cmpint (nm_setting_ip_config_get_num_addresses (s_ip4), ==, 1);
+	g_assert_cmpstr (nm_setting_ip_config_get_gateway (s_ip4), ==, "192.168.1.1");
+	g_assert_cmpint (nm_setting_ip_config_get_num_dns (s_ip4), ==, 1);
+	g_assert_cmpint (nm_setting_ip_config_get_route_metric (s_ip4), ==, 50);
+
+	s_ip6 = nm_connection_get_setting_ip6_config (con);
+	g_assert (s_ip6);
+	g_assert_cmpint (nm_setting_ip6_config_get_ip6_privacy (NM_SETTING_IP6_CONFIG (s_ip6)), ==, NM_SETTING_IP6_CONFIG_PRIVACY_PREFER_TEMP_ADDR);
+
+	/* a rough benchmark of nm_keyfile_read(), which is called for every
+	 * profile on startup and reload. */
+	if (nmtst_test_quick ())
+		return;
+
+	keyfile = g_key_file_new ();
+	if (!g_key_file_load_from_data (keyfile, _READ_1_KEYFILE, strlen (_READ_1_KEYFILE), G_KEY_FILE_NONE, &error))
+		g_assert_not_reached ();
+	g_assert_no_error (error);
+
+	n = 20000;
+	g_test_timer_start ();
+	for (i = 0; i < n; i++) {
+		gs_unref_object NMConnection *con2 = NULL;
+
+		con2 = nm_keyfile_read (keyfile, "/test_read_1", NULL, NULL, NULL, &error);
+		g_assert_no_error (error);
+		g_assert (con2);
+	}
+	g_test_message ("nm_keyfile_read(): reading %u profiles took %.3f seconds",
+	                n, g_test_timer_elapsed ());
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int main (int argc, char **argv)
@@ -749,6 +840,7 @@ int main (int argc, char **argv)
 	g_test_add_func ("/core/keyfile/test_team_conf_read/invalid", test_team_conf_read_invalid);
 	g_test_add_func ("/core/keyfile/test_user/1", test_user_1);
 	g_test_add_func ("/core/keyfile/test_vpn/1", test_vpn_1);
+	g_test_add_func ("/core/keyfile/test_read/1", test_read_1);
 
 	return g_test_run ();
 }
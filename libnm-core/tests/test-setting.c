@@ -1942,6 +1942,70 @@ test_tc_config_dbus (void)
 	g_object_unref (connection2);
 }
 
+static void
+test_setting_compare_native (void)
+{
+	gs_unref_object NMConnection *con = NULL;
+	gs_unref_object NMConnection *clone = NULL;
+	gs_unref_hashtable GHashTable *diffs = NULL;
+	NMSettingConnection *s_con;
+	NMSettingConnection *s_con_clone;
+	NMSettingWired *s_wired_clone;
+	GHashTable *setting_diffs;
+	guint i, n;
+
+	con = nmtst_create_minimal_connection ("test-compare", NULL, NM_SETTING_WIRED_SETTING_NAME, &s_con);
+	g_object_set (s_con,
+	              NM_SETTING_CONNECTION_AUTOCONNECT_PRIORITY, 5,
+	              NM_SETTING_CONNECTION_ZONE, "work",
+	              NULL);
+
+	clone = nm_simple_connection_new_clone (con);
+	s_con_clone = nm_connection_get_setting_connection (clone);
+	s_wired_clone = nm_connection_get_setting_wired (clone);
+	g_assert (nm_connection_compare (con, clone, NM_SETTING_COMPARE_FLAG_EXACT));
+
+	/* string */
+	g_object_set (s_con_clone, NM_SETTING_CONNECTION_ZONE, NULL, NULL);
+	g_assert (!nm_setting_compare (NM_SETTING (s_con), NM_SETTING (s_con_clone), NM_SETTING_COMPARE_FLAG_EXACT));
+	g_object_set (s_con_clone, NM_SETTING_CONNECTION_ZONE, "work", NULL);
+	g_assert (nm_setting_compare (NM_SETTING (s_con), NM_SETTING (s_con_clone), NM_SETTING_COMPARE_FLAG_EXACT));
+
+	/* int */
+	g_object_set (s_con_clone, NM_SETTING_CONNECTION_AUTOCONNECT_PRIORITY, 0, NULL);
+	g_assert (!nm_setting_compare (NM_SETTING (s_con), NM_SETTING (s_con_clone), NM_SETTING_COMPARE_FLAG_EXACT));
+	g_object_set (s_con_clone, NM_SETTING_CONNECTION_AUTOCONNECT_PRIORITY, 5, NULL);
+
+	/* boolean */
+	g_object_set (s_con_clone, NM_SETTING_CONNECTION_AUTOCONNECT, FALSE, NULL);
+	g_assert (!nm_setting_compare (NM_SETTING (s_con), NM_SETTING (s_con_clone), NM_SETTING_COMPARE_FLAG_EXACT));
+	g_object_set (s_con_clone, NM_SETTING_CONNECTION_AUTOCONNECT, TRUE, NULL);
+
+	/* uint, reported by nm_connection_diff() */
+	g_object_set (s_wired_clone, NM_SETTING_WIRED_MTU, (guint) 1400, NULL);
+	g_assert (!nm_connection_diff (con, clone, NM_SETTING_COMPARE_FLAG_EXACT, &diffs));
+	g_assert (diffs);
+	g_assert_cmpint (g_hash_table_size (diffs), ==, 1);
+	setting_diffs = g_hash_table_lookup (diffs, NM_SETTING_WIRED_SETTING_NAME);
+	g_assert (setting_diffs);
+	g_assert (g_hash_table_contains (setting_diffs, NM_SETTING_WIRED_MTU));
+	g_object_set (s_wired_clone, NM_SETTING_WIRED_MTU, (guint) 0, NULL);
+
+	g_assert (nm_connection_compare (con, clone, NM_SETTING_COMPARE_FLAG_EXACT));
+
+	/* a rough benchmark of nm_connection_compare(), which is used for every
+	 * update, reapply check and autoconnect evaluation. */
+	if (nmtst_test_quick ())
+		return;
+
+	n = 100000;
+	g_test_timer_start ();
+	for (i = 0; i < n; i++)
+		g_assert (nm_connection_compare (con, clone, NM_SETTING_COMPARE_FLAG_EXACT));
+	g_test_message ("nm_connection_compare(): %u comparisons took %.3f seconds",
+	                n, g_test_timer_elapsed ());
+}
+
 /*****************************************************************************/
 
 NMTST_DEFINE ();
@@ -1964,6 +2028,8 @@ main (int argc, char **argv)
 	                      "test-cert.p12, test",
 	                      test_8021x);
 
+	g_test_add_func ("/libnm/settings/compare/native", test_setting_compare_native);
+
 	g_test_add_func ("/libnm/settings/bond/verify", test_bond_verify);
 	g_test_add_func ("/libnm/settings/bond/compare", test_bond_compare);
 	g_test_add_func ("/libnm/settings/bond/normalize", test_bond_normalize);
@@ -113,6 +113,7 @@ typedef struct {
 	GDBusObjectManager *object_manager;
 	GCancellable *new_object_manager_cancellable;
 	struct udev *udev;
+	NMClientInstanceFlags instance_flags;
 	bool udev_inited:1;
 } NMClientPrivate;
 
@@ -145,6 +146,7 @@ enum {
 	PROP_DNS_RC_MANAGER,
 	PROP_DNS_CONFIGURATION,
 	PROP_CHECKPOINTS,
+	PROP_INSTANCE_FLAGS,
 
 	LAST_PROP
 };
@@ -2607,12 +2609,29 @@ obj_nm_for_gdbus_object (NMClient *self, GDBusObject *object, GDBusObjectManager
 	if (type == G_TYPE_INVALID)
 		return NULL;
 
+	/* Skip the objects the user is not interested in. Properties that
+	 * refer to them are resolved to no object. */
+	priv = NM_CLIENT_GET_PRIVATE (self);
+	if (priv->instance_flags != NM_CLIENT_INSTANCE_FLAGS_NONE) {
+		if (   NM_FLAGS_HAS (priv->instance_flags, NM_CLIENT_INSTANCE_FLAGS_NO_ACCESS_POINTS)
+		    && type == NM_TYPE_ACCESS_POINT)
+			return NULL;
+		if (   NM_FLAGS_HAS (priv->instance_flags, NM_CLIENT_INSTANCE_FLAGS_NO_CONNECTIONS)
+		    && type == NM_TYPE_REMOTE_CONNECTION)
+			return NULL;
+		if (   NM_FLAGS_HAS (priv->instance_flags, NM_CLIENT_INSTANCE_FLAGS_NO_IP_CONFIGS)
+		    && NM_IN_SET (type, NM_TYPE_IP4_CONFIG,
+		                        NM_TYPE_IP6_CONFIG,
+		                        NM_TYPE_DHCP4_CONFIG,
+		                        NM_TYPE_DHCP6_CONFIG))
+			return NULL;
+	}
+
 	obj_nm = g_object_new (type,
 	                       NM_OBJECT_DBUS_OBJECT, object,
 	                       NM_OBJECT_DBUS_OBJECT_MANAGER, object_manager,
 	                       NULL);
 	if (NM_IS_DEVICE (obj_nm)) {
-		priv = NM_CLIENT_GET_PRIVATE (self);
 		if (G_UNLIKELY (!priv->udev_inited)) {
 			priv->udev_inited = TRUE;
 			/* for testing, we don't want to use udev in libnm. */
@@ -3090,6 +3109,10 @@ set_property (GObject *object, guint prop_id,
 		if (priv->manager)
 			g_object_set_property (G_OBJECT (priv->manager), pspec->name, value);
 		break;
+	case PROP_INSTANCE_FLAGS:
+		/* construct-only */
+		priv->instance_flags = g_value_get_flags (value);
+		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
@@ -3223,6 +3246,9 @@ get_property (GObject *object, guint prop_id,
 		} else
 			g_value_take_boxed (value, NULL);
 		break;
+	case PROP_INSTANCE_FLAGS:
+		g_value_set_flags (value, priv->instance_flags);
+		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
@@ -3596,6 +3622,23 @@ nm_client_class_init (NMClientClass *client_class)
 		                     G_PARAM_READABLE |
 		                     G_PARAM_STATIC_STRINGS));
 
+	/**
+	 * NMClient:instance-flags:
+	 *
+	 * #NMClientInstanceFlags that select which kinds of objects the
+	 * #NMClient does not create.
+	 *
+	 * Since: 1.16
+	 */
+	g_object_class_install_property
+		(object_class, PROP_INSTANCE_FLAGS,
+		 g_param_spec_flags (NM_CLIENT_INSTANCE_FLAGS, "", "",
+		                     NM_TYPE_CLIENT_INSTANCE_FLAGS,
+		                     NM_CLIENT_INSTANCE_FLAGS_NONE,
+		                     G_PARAM_READWRITE |
+		                     G_PARAM_CONSTRUCT_ONLY |
+		                     G_PARAM_STATIC_STRINGS));
+
 	/* signals */
 
 	/**
@@ -63,6 +63,7 @@ G_BEGIN_DECLS
 #define NM_CLIENT_DNS_MODE "dns-mode"
 #define NM_CLIENT_DNS_RC_MANAGER "dns-rc-manager"
 #define NM_CLIENT_DNS_CONFIGURATION "dns-configuration"
+#define NM_CLIENT_INSTANCE_FLAGS "instance-flags"
 
 #define NM_CLIENT_DEVICE_ADDED "device-added"
 #define NM_CLIENT_DEVICE_REMOVED "device-removed"
@@ -153,6 +154,31 @@ typedef enum {
 	NM_CLIENT_PERMISSION_RESULT_NO
 } NMClientPermissionResult;
 
+/**
+ * NMClientInstanceFlags:
+ * @NM_CLIENT_INSTANCE_FLAGS_NONE: no special flags
+ * @NM_CLIENT_INSTANCE_FLAGS_NO_ACCESS_POINTS: don't create #NMAccessPoint
+ *   objects. Wi-Fi devices will report no access points.
+ * @NM_CLIENT_INSTANCE_FLAGS_NO_CONNECTIONS: don't create #NMRemoteConnection
+ *   objects. The list of connections will be empty and adding a connection
+ *   fails to return the new #NMRemoteConnection.
+ * @NM_CLIENT_INSTANCE_FLAGS_NO_IP_CONFIGS: don't create #NMIPConfig and
+ *   #NMDhcpConfig objects. Devices and active connections will report
+ *   no IP and DHCP configuration.
+ *
+ * Flags for #NMClient:instance-flags, which allow a client that does not
+ * need some kinds of objects to skip creating them. This makes
+ * initializing the #NMClient cheaper on hosts with many of these objects.
+ *
+ * Since: 1.16
+ **/
+typedef enum { /*< flags >*/
+	NM_CLIENT_INSTANCE_FLAGS_NONE              = 0,
+	NM_CLIENT_INSTANCE_FLAGS_NO_ACCESS_POINTS  = 0x1,
+	NM_CLIENT_INSTANCE_FLAGS_NO_CONNECTIONS    = 0x2,
+	NM_CLIENT_INSTANCE_FLAGS_NO_IP_CONFIGS     = 0x4,
+} NMClientInstanceFlags;
+
 /**
  * NMClientError:
  * @NM_CLIENT_ERROR_FAILED: unknown or unclassified error
@@ -62,6 +62,13 @@ typedef struct {
 	GPtrArray *devices;
 	GPtrArray *all_devices;
 	GPtrArray *active_connections;
+
+	/* Indexes of @devices by object path and interface name. NMObject
+	 * replaces the array on every change, so they are valid as long as
+	 * @devices_idx_array is @devices. */
+	GPtrArray *devices_idx_array;
+	GHashTable *devices_by_path;
+	GHashTable *devices_by_iface;
 	GPtrArray *checkpoints;
 	GSList *added_checkpoints;
 	NMConnectivityState connectivity;
@@ -786,23 +793,58 @@ nm_manager_get_all_devices (NMManager *manager)
 	return NM_MANAGER_GET_PRIVATE (manager)->all_devices;
 }
 
-NMDevice *
-nm_manager_get_device_by_path (NMManager *manager, const char *object_path)
+static void
+devices_idx_clear (NMManager *manager)
 {
-	const GPtrArray *devices;
+	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (manager);
+
+	g_clear_pointer (&priv->devices_idx_array, g_ptr_array_unref);
+	g_clear_pointer (&priv->devices_by_path, g_hash_table_unref);
+	g_clear_pointer (&priv->devices_by_iface, g_hash_table_unref);
+}
+
+static void
+devices_idx_ensure (NMManager *manager)
+{
+	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (manager);
 	guint i;
 
+	if (   priv->devices_idx_array
+	    && priv->devices_idx_array == priv->devices)
+		return;
+
+	devices_idx_clear (manager);
+
+	/* keep a reference to the indexed array, so that its address
+	 * cannot be reused by a later array. */
+	priv->devices_idx_array = g_ptr_array_ref (priv->devices);
+	priv->devices_by_path = g_hash_table_new (nm_str_hash, g_str_equal);
+	priv->devices_by_iface = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, NULL);
+
+	for (i = 0; i < priv->devices->len; i++) {
+		NMDevice *candidate = g_ptr_array_index (priv->devices, i);
+		const char *s;
+
+		/* the object path never changes and the device is kept alive
+		 * by the array, so the path doesn't need to be copied. */
+		s = nm_object_get_path (NM_OBJECT (candidate));
+		if (s && !g_hash_table_contains (priv->devices_by_path, s))
+			g_hash_table_insert (priv->devices_by_path, (gpointer) s, candidate);
+
+		s = nm_device_get_iface (candidate);
+		if (s && !g_hash_table_contains (priv->devices_by_iface, s))
+			g_hash_table_insert (priv->devices_by_iface, g_strdup (s), candidate);
+	}
+}
+
+NMDevice *
+nm_manager_get_device_by_path (NMManager *manager, const char *object_path)
+{
 	g_return_val_if_fail (NM_IS_MANAGER (manager), NULL);
 	g_return_val_if_fail (object_path, NULL);
 
-	devices = nm_manager_get_devices (manager);
-	for (i = 0; i < devices->len; i++) {
-		NMDevice *candidate = g_ptr_array_index (devices, i);
-		if (!strcmp (nm_object_get_path (NM_OBJECT (candidate)), object_path)) {
-			return candidate;
-		}
-	}
-	return NULL;
+	devices_idx_ensure (manager);
+	return g_hash_table_lookup (NM_MANAGER_GET_PRIVATE (manager)->devices_by_path, object_path);
 }
 
 static NMCheckpoint *
@@ -823,23 +865,30 @@ get_checkpoint_by_path (NMManager *manager, const char *object_path)
 NMDevice *
 nm_manager_get_device_by_iface (NMManager *manager, const char *iface)
 {
-	const GPtrArray *devices;
-	int i;
-	NMDevice *device = NULL;
+	NMManagerPrivate *priv;
+	NMDevice *device;
+	guint i;
 
 	g_return_val_if_fail (NM_IS_MANAGER (manager), NULL);
 	g_return_val_if_fail (iface, NULL);
 
-	devices = nm_manager_get_devices (manager);
-	for (i = 0; i < devices->len; i++) {
-		NMDevice *candidate = g_ptr_array_index (devices, i);
-		if (!strcmp (nm_device_get_iface (candidate), iface)) {
-			device = candidate;
-			break;
-		}
-	}
+	priv = NM_MANAGER_GET_PRIVATE (manager);
+
+	devices_idx_ensure (manager);
+	device = g_hash_table_lookup (priv->devices_by_iface, iface);
+	if (   device
+	    && nm_streq0 (nm_device_get_iface (device), iface))
+		return device;
 
-	return device;
+	/* the notification about a renamed device is delivered from an idle
+	 * handler, so the index might not know about the new name yet. */
+	for (i = 0; i < priv->devices->len; i++) {
+		NMDevice *candidate = g_ptr_array_index (priv->devices, i);
+
+		if (nm_streq0 (nm_device_get_iface (candidate), iface))
+			return candidate;
+	}
+	return NULL;
 }
 
 /*****************************************************************************/
@@ -1162,17 +1211,26 @@ device_ac_changed (GObject *object, GParamSpec *pspec, gpointer user_data)
 	recheck_pending_activations (self);
 }
 
+static void
+device_iface_changed (GObject *object, GParamSpec *pspec, gpointer user_data)
+{
+	devices_idx_clear (user_data);
+}
+
 static void
 device_added (NMManager *self, NMDevice *device)
 {
 	g_signal_connect_object (device, "notify::" NM_DEVICE_ACTIVE_CONNECTION,
 	                         G_CALLBACK (device_ac_changed), self, 0);
+	g_signal_connect_object (device, "notify::" NM_DEVICE_INTERFACE,
+	                         G_CALLBACK (device_iface_changed), self, 0);
 }
 
 static void
 device_removed (NMManager *self, NMDevice *device)
 {
 	g_signal_handlers_disconnect_by_func (device, G_CALLBACK (device_ac_changed), self);
+	g_signal_handlers_disconnect_by_func (device, G_CALLBACK (device_iface_changed), self);
 }
 
 static void
@@ -1723,6 +1781,7 @@ dispose (GObject *object)
 
 	nm_clear_g_cancellable (&priv->perm_call_cancellable);
 
+	devices_idx_clear (manager);
 	if (priv->devices) {
 		g_ptr_array_unref (priv->devices);
 		priv->devices = NULL;
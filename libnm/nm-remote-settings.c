@@ -46,6 +46,13 @@ typedef struct {
 	GPtrArray *all_connections;
 	GPtrArray *visible_connections;
 
+	/* Indexes of @visible_connections by UUID, ID and path, mapping to the
+	 * first matching connection. Built on demand and dropped when
+	 * @visible_connections or one of the connections changes. */
+	GHashTable *idx_by_uuid;
+	GHashTable *idx_by_id;
+	GHashTable *idx_by_path;
+
 	/* AddConnectionInfo objects that are waiting for the connection to become initialized */
 	GSList *add_list;
 
@@ -121,26 +128,44 @@ add_connection_info_complete (NMRemoteSettings *self,
 	g_slice_free (AddConnectionInfo, info);
 }
 
+static void
+connections_idx_clear (NMRemoteSettings *self)
+{
+	NMRemoteSettingsPrivate *priv = NM_REMOTE_SETTINGS_GET_PRIVATE (self);
+
+	g_clear_pointer (&priv->idx_by_uuid, g_hash_table_unref);
+	g_clear_pointer (&priv->idx_by_id, g_hash_table_unref);
+	g_clear_pointer (&priv->idx_by_path, g_hash_table_unref);
+}
+
 typedef const char * (*ConnectionStringGetter) (NMConnection *);
 
 static NMRemoteConnection *
 get_connection_by_string (NMRemoteSettings *settings,
                           const char *string,
-                          ConnectionStringGetter get_comparison_string)
+                          ConnectionStringGetter get_comparison_string,
+                          GHashTable **p_idx)
 {
 	NMRemoteSettingsPrivate *priv;
 	NMConnection *candidate;
+	const char *s;
 	int i;
 
 	priv = NM_REMOTE_SETTINGS_GET_PRIVATE (settings);
 
-	for (i = 0; i < priv->visible_connections->len; i++) {
-		candidate = priv->visible_connections->pdata[i];
-		if (!g_strcmp0 (string, get_comparison_string (candidate)))
-			return NM_REMOTE_CONNECTION (candidate);
+	if (!*p_idx) {
+		*p_idx = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, NULL);
+		for (i = 0; i < priv->visible_connections->len; i++) {
+			candidate = priv->visible_connections->pdata[i];
+			s = get_comparison_string (candidate);
+			if (s && !g_hash_table_contains (*p_idx, s))
+				g_hash_table_insert (*p_idx, g_strdup (s), candidate);
+		}
 	}
 
-	return NULL;
+	candidate = g_hash_table_lookup (*p_idx, string);
+	nm_assert (!candidate || nm_streq0 (string, get_comparison_string (candidate)));
+	return candidate ? NM_REMOTE_CONNECTION (candidate) : NULL;
 }
 
 NMRemoteConnection *
@@ -149,7 +174,8 @@ nm_remote_settings_get_connection_by_id (NMRemoteSettings *settings, const char
 	g_return_val_if_fail (NM_IS_REMOTE_SETTINGS (settings), NULL);
 	g_return_val_if_fail (id != NULL, NULL);
 
-	return get_connection_by_string (settings, id, nm_connection_get_id);
+	return get_connection_by_string (settings, id, nm_connection_get_id,
+	                                 &NM_REMOTE_SETTINGS_GET_PRIVATE (settings)->idx_by_id);
 }
 
 NMRemoteConnection *
@@ -158,7 +184,8 @@ nm_remote_settings_get_connection_by_path (NMRemoteSettings *settings, const cha
 	g_return_val_if_fail (NM_IS_REMOTE_SETTINGS (settings), NULL);
 	g_return_val_if_fail (path != NULL, NULL);
 
-	return get_connection_by_string (settings, path, nm_connection_get_path);
+	return get_connection_by_string (settings, path, nm_connection_get_path,
+	                                 &NM_REMOTE_SETTINGS_GET_PRIVATE (settings)->idx_by_path);
 }
 
 NMRemoteConnection *
@@ -167,7 +194,16 @@ nm_remote_settings_get_connection_by_uuid (NMRemoteSettings *settings, const cha
 	g_return_val_if_fail (NM_IS_REMOTE_SETTINGS (settings), NULL);
 	g_return_val_if_fail (uuid != NULL, NULL);
 
-	return get_connection_by_string (settings, uuid, nm_connection_get_uuid);
+	return get_connection_by_string (settings, uuid, nm_connection_get_uuid,
+	                                 &NM_REMOTE_SETTINGS_GET_PRIVATE (settings)->idx_by_uuid);
+}
+
+static void
+connection_changed (NMConnection *connection,
+                    gpointer user_data)
+{
+	/* the ID or UUID of the connection might have changed. */
+	connections_idx_clear (NM_REMOTE_SETTINGS (user_data));
 }
 
 static void
@@ -189,6 +225,7 @@ cleanup_connection (NMRemoteSettings *self,
                     NMRemoteConnection *remote)
 {
 	g_signal_handlers_disconnect_by_func (remote, G_CALLBACK (connection_visible_changed), self);
+	g_signal_handlers_disconnect_by_func (remote, G_CALLBACK (connection_changed), self);
 }
 
 static void
@@ -213,6 +250,8 @@ connection_removed (NMRemoteSettings *self,
 	/* Allow the signal to propagate if and only if @remote was in visible_connections */
 	if (!g_ptr_array_remove (priv->visible_connections, remote))
 		g_signal_stop_emission (self, signals[CONNECTION_REMOVED], 0);
+	else
+		connections_idx_clear (self);
 }
 
 static void
@@ -229,11 +268,16 @@ connection_added (NMRemoteSettings *self,
 		                  "notify::" NM_REMOTE_CONNECTION_VISIBLE,
 		                  G_CALLBACK (connection_visible_changed),
 		                  self);
+		g_signal_connect (remote,
+		                  NM_CONNECTION_CHANGED,
+		                  G_CALLBACK (connection_changed),
+		                  self);
 	}
 
-	if (nm_remote_connection_get_visible (remote))
+	if (nm_remote_connection_get_visible (remote)) {
 		g_ptr_array_add (priv->visible_connections, remote);
-	else
+		connections_idx_clear (self);
+	} else
 		g_signal_stop_emission (self, signals[CONNECTION_ADDED], 0);
 
 	path = nm_connection_get_path (NM_CONNECTION (remote));
@@ -676,6 +720,7 @@ dispose (GObject *object)
 		g_clear_pointer (&priv->all_connections, g_ptr_array_unref);
 	}
 
+	connections_idx_clear (self);
 	g_clear_pointer (&priv->visible_connections, g_ptr_array_unref);
 	g_clear_pointer (&priv->hostname, g_free);
 	g_clear_object (&priv->proxy);
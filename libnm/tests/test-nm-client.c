@@ -778,6 +778,67 @@ test_devices_array (void)
 	g_clear_pointer (&sinfo, nmtstc_service_cleanup);
 }
 
+static void
+device_iface_notify_cb (NMDevice *device,
+                        GParamSpec *pspec,
+                        gpointer user_data)
+{
+	g_main_loop_quit (loop);
+}
+
+static void
+test_device_by_iface (void)
+{
+	gs_unref_object NMClient *client = NULL;
+	NMDevice *eth0, *eth1;
+	GError *error = NULL;
+	GVariant *ret;
+	guint quit_id;
+
+	sinfo = nmtstc_service_init ();
+	if (!nmtstc_service_available (sinfo))
+		return;
+
+	client = nm_client_new (NULL, &error);
+	g_assert_no_error (error);
+
+	eth0 = nmtstc_service_add_device (sinfo, client, "AddWiredDevice", "eth0");
+	eth1 = nmtstc_service_add_device (sinfo, client, "AddWiredDevice", "eth1");
+
+	/* the lookups build the index... */
+	g_assert (nm_client_get_device_by_iface (client, "eth0") == eth0);
+	g_assert (nm_client_get_device_by_iface (client, "eth1") == eth1);
+	g_assert (nm_client_get_device_by_path (client, nm_object_get_path (NM_OBJECT (eth1))) == eth1);
+	g_assert (!nm_client_get_device_by_iface (client, "eth2"));
+
+	/* ... which must follow a rename of a device. */
+	ret = g_dbus_proxy_call_sync (sinfo->proxy,
+	                              "SetProperties",
+	                              g_variant_new_parsed ("[(%o, [('org.freedesktop.NetworkManager.Device', [('Interface', <'eth2'>)])])]",
+	                                                    nm_object_get_path (NM_OBJECT (eth0))),
+	                              G_DBUS_CALL_FLAGS_NO_AUTO_START,
+	                              3000,
+	                              NULL,
+	                              &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+	g_variant_unref (ret);
+
+	g_signal_connect (eth0, "notify::" NM_DEVICE_INTERFACE,
+	                  G_CALLBACK (device_iface_notify_cb), NULL);
+	quit_id = g_timeout_add_seconds (5, loop_quit, loop);
+	g_main_loop_run (loop);
+	g_signal_handlers_disconnect_by_func (eth0, device_iface_notify_cb, NULL);
+
+	g_assert_cmpstr (nm_device_get_iface (eth0), ==, "eth2");
+	nm_clear_g_source (&quit_id);
+	g_assert (nm_client_get_device_by_iface (client, "eth2") == eth0);
+	g_assert (!nm_client_get_device_by_iface (client, "eth0"));
+	g_assert (nm_client_get_device_by_iface (client, "eth1") == eth1);
+
+	g_clear_pointer (&sinfo, nmtstc_service_cleanup);
+}
+
 static void
 nm_running_changed (GObject *client,
                     GParamSpec *pspec,
@@ -1595,6 +1656,75 @@ test_connection_invalid (void)
 
 /*****************************************************************************/
 
+static void
+test_instance_flags (void)
+{
+	NMTSTC_SERVICE_INFO_SETUP (my_sinfo)
+	gs_unref_object NMConnection *connection = NULL;
+	gs_unref_object NMClient *client = NULL;
+	gs_unref_object NMClient *client_flags = NULL;
+	gs_unref_variant GVariant *ret = NULL;
+	gs_free_error GError *error = NULL;
+	NMDevice *wifi;
+	NMDevice *wired;
+
+	client = nm_client_new (NULL, &error);
+	g_assert_no_error (error);
+
+	wired = nmtstc_service_add_wired_device (my_sinfo, client, "eth0", "52:54:00:12:34:56", NULL);
+	g_assert (NM_IS_DEVICE_ETHERNET (wired));
+	wifi = nmtstc_service_add_device (my_sinfo, client, "AddWifiDevice", "wlan0");
+	g_assert (NM_IS_DEVICE_WIFI (wifi));
+
+	ret = g_dbus_proxy_call_sync (my_sinfo->proxy,
+	                              "AddWifiAp",
+	                              g_variant_new ("(sss)", "wlan0", "test-ap", expected_bssid),
+	                              G_DBUS_CALL_FLAGS_NO_AUTO_START,
+	                              3000,
+	                              NULL,
+	                              &error);
+	g_assert_no_error (error);
+	g_assert (ret);
+
+	connection = nmtst_create_minimal_connection ("test-instance-flags", NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+	nmtst_connection_normalize (connection);
+	nmtstc_service_add_connection (my_sinfo,
+	                               connection,
+	                               TRUE,
+	                               NULL);
+
+	/* a new client without flags sees everything... */
+	g_clear_object (&client);
+	client = nm_client_new (NULL, &error);
+	g_assert_no_error (error);
+
+	g_assert_cmpint (nm_client_get_connections (client)->len, ==, 1);
+	g_assert_cmpint (nm_client_get_devices (client)->len, ==, 2);
+	wifi = nm_client_get_device_by_iface (client, "wlan0");
+	g_assert (NM_IS_DEVICE_WIFI (wifi));
+	g_assert_cmpint (nm_device_wifi_get_access_points (NM_DEVICE_WIFI (wifi))->len, ==, 1);
+
+	/* ... while the flags hide access points and connections, but not the
+	 * devices that own them. */
+	client_flags = g_initable_new (NM_TYPE_CLIENT, NULL, &error,
+	                               NM_CLIENT_INSTANCE_FLAGS, (guint) (  NM_CLIENT_INSTANCE_FLAGS_NO_ACCESS_POINTS
+	                                                                  | NM_CLIENT_INSTANCE_FLAGS_NO_CONNECTIONS),
+	                               NULL);
+	g_assert_no_error (error);
+	g_assert (NM_IS_CLIENT (client_flags));
+
+	g_assert_cmpint (nm_client_get_connections (client_flags)->len, ==, 0);
+	g_assert_cmpint (nm_client_get_devices (client_flags)->len, ==, 2);
+	wired = nm_client_get_device_by_iface (client_flags, "eth0");
+	g_assert (NM_IS_DEVICE_ETHERNET (wired));
+	wifi = nm_client_get_device_by_iface (client_flags, "wlan0");
+	g_assert (NM_IS_DEVICE_WIFI (wifi));
+	g_assert_cmpint (nm_device_wifi_get_access_points (NM_DEVICE_WIFI (wifi))->len, ==, 0);
+	g_assert (!nm_device_wifi_get_active_access_point (NM_DEVICE_WIFI (wifi)));
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -1611,12 +1741,14 @@ main (int argc, char **argv)
 	g_test_add_func ("/libnm/wifi-ap-added-removed", test_wifi_ap_added_removed);
 	g_test_add_func ("/libnm/wimax-nsp-added-removed", test_wimax_nsp_added_removed);
 	g_test_add_func ("/libnm/devices-array", test_devices_array);
+	g_test_add_func ("/libnm/device-by-iface", test_device_by_iface);
 	g_test_add_func ("/libnm/client-nm-running", test_client_nm_running);
 	g_test_add_func ("/libnm/active-connections", test_active_connections);
 	g_test_add_func ("/libnm/activate-virtual", test_activate_virtual);
 	g_test_add_func ("/libnm/activate-failed", test_activate_failed);
 	g_test_add_func ("/libnm/device-connection-compatibility", test_device_connection_compatibility);
 	g_test_add_func ("/libnm/connection/invalid", test_connection_invalid);
+	g_test_add_func ("/libnm/instance-flags", test_instance_flags);
 
 	return g_test_run ();
 }
@@ -76,6 +76,20 @@
           <citerefentry><refentrytitle>nm-settings</refentrytitle><manvolnum>5</manvolnum>
           </citerefentry> and <emphasis>nmcli con (re)load</emphasis>).
         </para>
+        <para>
+          Many similar profiles can share their common settings by using a
+          template. A template is a keyfile with the suffix
+          <filename>.nmtemplate</filename> in the same directory as the profiles
+          that use it. NetworkManager does not load templates as profiles
+          by themselves. A profile names its template with the <literal>name</literal>
+          key in the <literal>[template]</literal> section. It is read as if all
+          keys of the template were part of the profile, and keys set in the profile
+          take precedence. A UUID in the template is ignored. NetworkManager does not
+          notice changes to a template by itself, so reload the profiles after
+          modifying one. When NetworkManager saves a profile that is based on a template,
+          it writes all settings to the profile and the profile no longer
+          uses the template.
+        </para>
         <formalpara>
           <title>Examples of <emphasis>keyfile</emphasis> configuration</title>
           <para>
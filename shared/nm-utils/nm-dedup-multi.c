@@ -1119,3 +1119,20 @@ more:
 	g_slice_free (NMDedupMultiIndex, self);
 	return NULL;
 }
+
+/**
+ * nm_dedup_multi_index_get_stats:
+ * @self: the index
+ * @out_n_entries: (allow-none): the number of entries, including the head entries
+ * @out_n_objs: (allow-none): the number of distinct, interned objects
+ */
+void
+nm_dedup_multi_index_get_stats (const NMDedupMultiIndex *self,
+                                guint *out_n_entries,
+                                guint *out_n_objs)
+{
+	g_return_if_fail (self);
+
+	NM_SET_OUT (out_n_entries, g_hash_table_size (self->idx_entries));
+	NM_SET_OUT (out_n_objs, g_hash_table_size (self->idx_objs));
+}
@@ -270,6 +270,10 @@ NMDedupMultiIndex *nm_dedup_multi_index_new (void);
 NMDedupMultiIndex *nm_dedup_multi_index_ref (NMDedupMultiIndex *self);
 NMDedupMultiIndex *nm_dedup_multi_index_unref (NMDedupMultiIndex *self);
 
+void nm_dedup_multi_index_get_stats (const NMDedupMultiIndex *self,
+                                     guint *out_n_entries,
+                                     guint *out_n_objs);
+
 static inline void
 _nm_auto_unref_dedup_multi_index (NMDedupMultiIndex **v)
 {
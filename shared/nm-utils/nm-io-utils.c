@@ -325,28 +325,21 @@ nm_utils_file_get_contents (int dirfd,
 
 /*****************************************************************************/
 
-/*
- * Copied from GLib's g_file_set_contents() et al., but allows
- * specifying a mode for the new file.
- */
-gboolean
-nm_utils_file_set_contents (const char *filename,
-                            const char *contents,
-                            gssize length,
-                            mode_t mode,
-                            GError **error)
+/* Writes @contents to a new temporary file next to @filename and returns
+ * the open file descriptor, or -1 on failure. */
+static int
+_file_write_tmp (const char *filename,
+                 const char *contents,
+                 gssize length,
+                 mode_t mode,
+                 char **out_tmp_name,
+                 GError **error)
 {
 	gs_free char *tmp_name = NULL;
-	struct stat statbuf;
 	int errsv;
 	gssize s;
 	int fd;
 
-	g_return_val_if_fail (filename, FALSE);
-	g_return_val_if_fail (contents || !length, FALSE);
-	g_return_val_if_fail (!error || !*error, FALSE);
-	g_return_val_if_fail (length >= -1, FALSE);
-
 	if (length == -1)
 		length = strlen (contents);
 
@@ -360,7 +353,7 @@ nm_utils_file_set_contents (const char *filename,
 		             "failed to create file %s: %s",
 		             tmp_name,
 		             g_strerror (errsv));
-		return FALSE;
+		return -1;
 	}
 
 	while (length > 0) {
@@ -379,7 +372,7 @@ nm_utils_file_set_contents (const char *filename,
 			             "failed to write to file %s: %s",
 			             tmp_name,
 			             g_strerror (errsv));
-			return FALSE;
+			return -1;
 		}
 
 		g_assert (s <= length);
@@ -388,6 +381,74 @@ nm_utils_file_set_contents (const char *filename,
 		length -= s;
 	}
 
+	*out_tmp_name = g_steal_pointer (&tmp_name);
+	return fd;
+}
+
+/**
+ * nm_utils_file_write_tmp:
+ * @filename: the final name of the file
+ * @contents: the data to write
+ * @length: the length of @contents, or -1 if it is NUL terminated
+ * @mode: the file mode of the new file
+ * @out_tmp_name: (out): the name of the written temporary file
+ * @error: the error location
+ *
+ * Like nm_utils_file_set_contents(), but only writes a temporary file
+ * next to @filename. It neither syncs the file nor renames it. That is
+ * up to the caller, which can so make several files durable at once.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean
+nm_utils_file_write_tmp (const char *filename,
+                         const char *contents,
+                         gssize length,
+                         mode_t mode,
+                         char **out_tmp_name,
+                         GError **error)
+{
+	int fd;
+
+	g_return_val_if_fail (filename, FALSE);
+	g_return_val_if_fail (contents || !length, FALSE);
+	g_return_val_if_fail (!error || !*error, FALSE);
+	g_return_val_if_fail (length >= -1, FALSE);
+	g_return_val_if_fail (out_tmp_name && !*out_tmp_name, FALSE);
+
+	fd = _file_write_tmp (filename, contents, length, mode, out_tmp_name, error);
+	if (fd < 0)
+		return FALSE;
+
+	nm_close (fd);
+	return TRUE;
+}
+
+/*
+ * Copied from GLib's g_file_set_contents() et al., but allows
+ * specifying a mode for the new file.
+ */
+gboolean
+nm_utils_file_set_contents (const char *filename,
+                            const char *contents,
+                            gssize length,
+                            mode_t mode,
+                            GError **error)
+{
+	gs_free char *tmp_name = NULL;
+	struct stat statbuf;
+	int errsv;
+	int fd;
+
+	g_return_val_if_fail (filename, FALSE);
+	g_return_val_if_fail (contents || !length, FALSE);
+	g_return_val_if_fail (!error || !*error, FALSE);
+	g_return_val_if_fail (length >= -1, FALSE);
+
+	fd = _file_write_tmp (filename, contents, length, mode, &tmp_name, error);
+	if (fd < 0)
+		return FALSE;
+
 	/* If the final destination exists and is > 0 bytes, we want to sync the
 	 * newly written file to ensure the data is on disk when we rename over
 	 * the destination. Otherwise if we get a system crash we can lose both
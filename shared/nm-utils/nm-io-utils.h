@@ -60,4 +60,11 @@ gboolean nm_utils_file_set_contents (const char *filename,
                                      mode_t mode,
                                      GError **error);
 
+gboolean nm_utils_file_write_tmp (const char *filename,
+                                  const char *contents,
+                                  gssize length,
+                                  mode_t mode,
+                                  char **out_tmp_name,
+                                  GError **error);
+
 #endif /* __NM_IO_UTILS_H__ */
@@ -5936,6 +5936,7 @@ activation_source_handle_cb (NMDevice *self,
                              int addr_family)
 {
 	ActivationHandleData *act_data, a;
+	nm_latency_measure_scope (NM_LATENCY_POINT_DEVICE_ACTIVATION_STAGE);
 
 	g_return_if_fail (NM_IS_DEVICE (self));
 
@@ -15811,6 +15812,8 @@ nm_device_init (NMDevice *self)
 
 	self->_priv = priv;
 
+	nm_utils_alive_counter_inc (NM_UTILS_ALIVE_COUNTER_DEVICE);
+
 	c_list_init (&priv->concheck_lst_head);
 	c_list_init (&self->devices_lst);
 	c_list_init (&priv->slaves);
@@ -16036,6 +16039,8 @@ finalize (GObject *object)
 
 	_LOGD (LOGD_DEVICE, "finalize(): %s", G_OBJECT_TYPE_NAME (self));
 
+	nm_utils_alive_counter_dec (NM_UTILS_ALIVE_COUNTER_DEVICE);
+
 	g_free (priv->hw_addr);
 	g_free (priv->hw_addr_perm);
 	g_free (priv->hw_addr_initial);
@@ -1367,6 +1367,7 @@ update_dns (NMDnsManager *self,
 	SpawnResult result = SR_ERROR;
 	NMConfigData *data;
 	NMGlobalDnsConfig *global_config;
+	nm_latency_measure_scope (NM_LATENCY_POINT_DNS_UPDATE);
 
 	g_return_val_if_fail (!error || !*error, FALSE);
 
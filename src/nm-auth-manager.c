@@ -34,6 +34,13 @@
 #define CANCELLATION_ID_PREFIX "cancellation-id-"
 #define CANCELLATION_TIMEOUT_MS 5000
 
+/* Results of CheckAuthorization are cached for a short while, so that
+ * a burst of requests from the same process (like GetPermissions, or an
+ * NMAuthChain asking for several actions) results in only one round-trip
+ * to polkit per action. Only checks without user interaction are cached. */
+#define AUTH_CACHE_TIMEOUT_MS   5000
+#define AUTH_CACHE_MAX_ENTRIES  256
+
 /*****************************************************************************/
 
 NM_GOBJECT_PROPERTIES_DEFINE_BASE (
@@ -53,6 +60,10 @@ typedef struct {
 	GCancellable *new_proxy_cancellable;
 	GCancellable *cancel_cancellable;
 	guint64 call_numid_counter;
+	GHashTable *auth_cache;
+	guint auth_cache_prune_id;
+	guint64 auth_cache_hits;
+	guint64 auth_cache_misses;
 	bool polkit_enabled:1;
 	bool disposing:1;
 	bool shutting_down:1;
@@ -126,8 +137,18 @@ typedef enum {
 typedef enum {
 	IDLE_REASON_AUTHORIZED,
 	IDLE_REASON_NO_DBUS,
+	IDLE_REASON_CACHED,
 } IdleReason;
 
+typedef struct {
+	gulong pid;
+	gulong uid;
+	guint64 start_time;
+	gint64 timestamp_ms;
+	bool is_authorized:1;
+	char action_id[];
+} AuthCacheEntry;
+
 struct _NMAuthManagerCallId {
 	CList calls_lst;
 	NMAuthManager *self;
@@ -135,11 +156,170 @@ struct _NMAuthManagerCallId {
 	GCancellable *dbus_cancellable;
 	NMAuthManagerCheckAuthorizationCallback callback;
 	gpointer user_data;
+	AuthCacheEntry *cache_entry;
 	guint64 call_numid;
 	guint idle_id;
 	IdleReason idle_reason:8;
+	bool cached_is_authorized:1;
 };
 
+/*****************************************************************************/
+
+static guint
+_auth_cache_entry_hash (gconstpointer ptr)
+{
+	const AuthCacheEntry *entry = ptr;
+	NMHashState h;
+
+	nm_hash_init (&h, 1762840853u);
+	nm_hash_update_vals (&h,
+	                     entry->pid,
+	                     entry->uid,
+	                     entry->start_time);
+	nm_hash_update_str (&h, entry->action_id);
+	return nm_hash_complete (&h);
+}
+
+static gboolean
+_auth_cache_entry_equal (gconstpointer a, gconstpointer b)
+{
+	const AuthCacheEntry *entry_a = a;
+	const AuthCacheEntry *entry_b = b;
+
+	return    entry_a->pid == entry_b->pid
+	       && entry_a->uid == entry_b->uid
+	       && entry_a->start_time == entry_b->start_time
+	       && nm_streq (entry_a->action_id, entry_b->action_id);
+}
+
+static AuthCacheEntry *
+_auth_cache_entry_new (NMAuthSubject *subject,
+                       const char *action_id)
+{
+	AuthCacheEntry *entry;
+	gsize l;
+
+	l = strlen (action_id) + 1;
+	entry = g_malloc (sizeof (AuthCacheEntry) + l);
+	entry->pid = nm_auth_subject_get_unix_process_pid (subject);
+	entry->uid = nm_auth_subject_get_unix_process_uid (subject);
+	entry->start_time = nm_auth_subject_get_unix_process_start_time (subject);
+	entry->timestamp_ms = 0;
+	entry->is_authorized = FALSE;
+	memcpy (entry->action_id, action_id, l);
+	return entry;
+}
+
+static void
+_auth_cache_clear (NMAuthManager *self)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (self);
+
+	nm_clear_g_source (&priv->auth_cache_prune_id);
+	if (   priv->auth_cache
+	    && g_hash_table_size (priv->auth_cache) > 0) {
+		_LOGT ("cache: drop %u entries (hits %"G_GUINT64_FORMAT", misses %"G_GUINT64_FORMAT")",
+		       g_hash_table_size (priv->auth_cache),
+		       priv->auth_cache_hits,
+		       priv->auth_cache_misses);
+		g_hash_table_remove_all (priv->auth_cache);
+	}
+}
+
+static gboolean
+_auth_cache_entry_is_expired (const AuthCacheEntry *entry, gint64 now_ms)
+{
+	return now_ms >= entry->timestamp_ms + AUTH_CACHE_TIMEOUT_MS;
+}
+
+static guint
+_auth_cache_prune (NMAuthManager *self)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (self);
+	GHashTableIter iter;
+	AuthCacheEntry *entry;
+	gint64 now_ms;
+
+	if (!priv->auth_cache)
+		return 0;
+
+	now_ms = nm_utils_get_monotonic_timestamp_ms ();
+	g_hash_table_iter_init (&iter, priv->auth_cache);
+	while (g_hash_table_iter_next (&iter, (gpointer *) &entry, NULL)) {
+		if (_auth_cache_entry_is_expired (entry, now_ms))
+			g_hash_table_iter_remove (&iter);
+	}
+	return g_hash_table_size (priv->auth_cache);
+}
+
+static gboolean
+_auth_cache_prune_cb (gpointer user_data)
+{
+	NMAuthManager *self = user_data;
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (self);
+
+	if (_auth_cache_prune (self) > 0)
+		return G_SOURCE_CONTINUE;
+
+	priv->auth_cache_prune_id = 0;
+	return G_SOURCE_REMOVE;
+}
+
+static const AuthCacheEntry *
+_auth_cache_lookup (NMAuthManager *self,
+                    const AuthCacheEntry *needle)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (self);
+	AuthCacheEntry *entry;
+
+	if (!priv->auth_cache)
+		return NULL;
+
+	entry = g_hash_table_lookup (priv->auth_cache, needle);
+	if (!entry)
+		return NULL;
+
+	if (_auth_cache_entry_is_expired (entry, nm_utils_get_monotonic_timestamp_ms ())) {
+		g_hash_table_remove (priv->auth_cache, entry);
+		return NULL;
+	}
+	return entry;
+}
+
+static void
+_auth_cache_add (NMAuthManager *self,
+                 AuthCacheEntry *entry,
+                 gboolean is_authorized)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (self);
+
+	if (!priv->auth_cache) {
+		priv->auth_cache = g_hash_table_new_full (_auth_cache_entry_hash,
+		                                          _auth_cache_entry_equal,
+		                                          g_free,
+		                                          NULL);
+	}
+
+	if (   g_hash_table_size (priv->auth_cache) >= AUTH_CACHE_MAX_ENTRIES
+	    && _auth_cache_prune (self) >= AUTH_CACHE_MAX_ENTRIES) {
+		/* still full. This only happens if we are flooded with requests
+		 * from many different processes. Just start over. */
+		g_hash_table_remove_all (priv->auth_cache);
+	}
+
+	entry->timestamp_ms = nm_utils_get_monotonic_timestamp_ms ();
+	entry->is_authorized = is_authorized;
+	g_hash_table_add (priv->auth_cache, entry);
+
+	if (!priv->auth_cache_prune_id) {
+		priv->auth_cache_prune_id = g_timeout_add (AUTH_CACHE_TIMEOUT_MS,
+		                                           _auth_cache_prune_cb,
+		                                           self);
+	}
+}
+
+/*****************************************************************************/
+
 #define cancellation_id_to_str_a(call_numid) \
 	nm_sprintf_bufa (NM_STRLEN (CANCELLATION_ID_PREFIX) + 20, \
 	                 CANCELLATION_ID_PREFIX"%"G_GUINT64_FORMAT, \
@@ -150,6 +330,7 @@ _call_id_free (NMAuthManagerCallId *call_id)
 {
 	c_list_unlink (&call_id->calls_lst);
 	nm_clear_g_source (&call_id->idle_id);
+	g_clear_pointer (&call_id->cache_entry, g_free);
 	if (call_id->dbus_parameters)
 		g_variant_unref (g_steal_pointer (&call_id->dbus_parameters));
 
@@ -264,6 +445,12 @@ _call_check_authorize_cb (GObject *proxy,
 		               NULL);
 		_LOG2T (call_id, "completed: authorized=%d, challenge=%d",
 		        is_authorized, is_challenge);
+
+		/* Only cache definite answers. A challenge depends on whether an
+		 * authentication agent is around, and must be asked for again. */
+		if (   call_id->cache_entry
+		    && !is_challenge)
+			_auth_cache_add (self, g_steal_pointer (&call_id->cache_entry), is_authorized);
 	} else
 		_LOG2T (call_id, "completed: failed: %s", error->message);
 
@@ -308,6 +495,10 @@ _call_on_idle (gpointer user_data)
 		is_authorized = TRUE;
 		_LOG2T (call_id, "completed: authorized=%d, challenge=%d (simulated)",
 		        is_authorized, is_challenge);
+	} else if (call_id->idle_reason == IDLE_REASON_CACHED) {
+		is_authorized = call_id->cached_is_authorized;
+		_LOG2T (call_id, "completed: authorized=%d, challenge=%d (cached)",
+		        is_authorized, is_challenge);
 	} else {
 		nm_assert (call_id->idle_reason == IDLE_REASON_NO_DBUS);
 		error_msg = "failure creating GDBusProxy for authorization request";
@@ -348,6 +539,8 @@ nm_auth_manager_check_authorization (NMAuthManager *self,
 	GVariant *subject_value;
 	GVariant *details_value;
 	NMAuthManagerCallId *call_id;
+	gs_free AuthCacheEntry *cache_entry = NULL;
+	const AuthCacheEntry *cached;
 
 	g_return_val_if_fail (NM_IS_AUTH_MANAGER (self), NULL);
 	g_return_val_if_fail (NM_IN_SET (nm_auth_subject_get_subject_type (subject),
@@ -389,7 +582,27 @@ nm_auth_manager_check_authorization (NMAuthManager *self,
 		_LOG2T (call_id, "CheckAuthorization(%s), subject=%s (failing due to invalid DBUS proxy)", action_id, nm_auth_subject_to_string (subject, subject_buf, sizeof (subject_buf)));
 		call_id->idle_reason = IDLE_REASON_NO_DBUS;
 		call_id->idle_id = g_idle_add (_call_on_idle, call_id);
+	} else if (   !allow_user_interaction
+	           /* without a start-time, the pid could get reused by another process
+	            * and we don't cache the result. Also, the result of an interactive
+	            * check depends on what the user answered in the authentication
+	            * dialog, which must not be reused for later requests. */
+	           && nm_auth_subject_get_unix_process_start_time (subject) != 0
+	           && (cache_entry = _auth_cache_entry_new (subject, action_id))
+	           && (cached = _auth_cache_lookup (self, cache_entry))) {
+		priv->auth_cache_hits++;
+		_LOG2T (call_id, "CheckAuthorization(%s), subject=%s (cached result, hits %"G_GUINT64_FORMAT", misses %"G_GUINT64_FORMAT")",
+		        action_id, nm_auth_subject_to_string (subject, subject_buf, sizeof (subject_buf)),
+		        priv->auth_cache_hits, priv->auth_cache_misses);
+		call_id->idle_reason = IDLE_REASON_CACHED;
+		call_id->cached_is_authorized = cached->is_authorized;
+		call_id->idle_id = g_idle_add (_call_on_idle, call_id);
 	} else {
+		if (cache_entry) {
+			priv->auth_cache_misses++;
+			call_id->cache_entry = g_steal_pointer (&cache_entry);
+		}
+
 		subject_value = nm_auth_subject_unix_process_to_polkit_gvariant (subject);
 		nm_assert (g_variant_is_floating (subject_value));
 
@@ -442,6 +655,8 @@ nm_auth_manager_check_authorization_cancel (NMAuthManagerCallId *call_id)
 static void
 _emit_changed_signal (NMAuthManager *self)
 {
+	_auth_cache_clear (self);
+
 	_LOGD ("emit changed signal");
 	g_signal_emit (self, signals[CHANGED_SIGNAL], 0);
 }
@@ -680,6 +895,9 @@ dispose (GObject *object)
 	nm_clear_g_cancellable (&priv->new_proxy_cancellable);
 	nm_clear_g_cancellable (&priv->cancel_cancellable);
 
+	_auth_cache_clear (self);
+	g_clear_pointer (&priv->auth_cache, g_hash_table_unref);
+
 	if (priv->proxy) {
 		g_signal_handlers_disconnect_by_data (priv->proxy, self);
 		g_clear_object (&priv->proxy);
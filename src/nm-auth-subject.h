@@ -61,6 +61,8 @@ const char *nm_auth_subject_get_unix_process_dbus_sender (NMAuthSubject *subject
 
 gulong nm_auth_subject_get_unix_process_uid (NMAuthSubject *subject);
 
+guint64 nm_auth_subject_get_unix_process_start_time (NMAuthSubject *subject);
+
 const char *nm_auth_subject_to_string (NMAuthSubject *self, char *buf, gsize buf_len);
 
 GVariant *  nm_auth_subject_unix_process_to_polkit_gvariant (NMAuthSubject *self);
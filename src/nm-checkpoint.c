@@ -102,6 +102,105 @@ G_DEFINE_TYPE (NMCheckpoint, nm_checkpoint, NM_TYPE_DBUS_OBJECT)
 
 /*****************************************************************************/
 
+/* Checkpoints keep a private copy of the applied and settings connection of
+ * each device. When checkpoints are taken repeatedly (or for many devices that
+ * share a profile), most of these copies are identical. Instead of cloning
+ * the live connection every time, remember the last snapshot on the live
+ * connection and hand out a new reference as long as the live connection did
+ * not change. The live connection only holds a weak pointer to the snapshot,
+ * so it does not keep it alive after the last checkpoint is gone.
+ *
+ * Snapshots are never modified. Whoever needs a mutable connection (like the
+ * activation during rollback) must clone it. */
+
+typedef struct {
+	NMConnection *live;
+	NMConnection *snapshot;
+} ConnectionSnapshotData;
+
+static GQuark
+_snapshot_quark (void)
+{
+	static GQuark quark = 0;
+
+	if (G_UNLIKELY (!quark))
+		quark = g_quark_from_static_string ("nm-checkpoint-snapshot");
+	return quark;
+}
+
+static void
+_snapshot_weak_notify_cb (gpointer user_data, GObject *where_the_object_was)
+{
+	ConnectionSnapshotData *data = user_data;
+
+	nm_assert ((GObject *) data->snapshot == where_the_object_was);
+
+	data->snapshot = NULL;
+	g_object_set_qdata (G_OBJECT (data->live), _snapshot_quark (), NULL);
+}
+
+static void
+_snapshot_data_free (gpointer user_data)
+{
+	ConnectionSnapshotData *data = user_data;
+
+	if (data->snapshot)
+		g_object_weak_unref (G_OBJECT (data->snapshot), _snapshot_weak_notify_cb, data);
+
+	/* during finalization of the live connection, the signal handlers are already gone. */
+	g_signal_handlers_disconnect_by_data (data->live, data);
+	g_slice_free (ConnectionSnapshotData, data);
+}
+
+static void
+_snapshot_live_changed_cb (NMConnection *live, gpointer user_data)
+{
+	/* the live connection was modified. Existing snapshots stay valid for
+	 * their holders, but must not be handed out anymore. */
+	g_object_set_qdata (G_OBJECT (live), _snapshot_quark (), NULL);
+}
+
+static void
+_snapshot_live_secrets_updated_cb (NMConnection *live, const char *setting_name, gpointer user_data)
+{
+	_snapshot_live_changed_cb (live, user_data);
+}
+
+static NMConnection *
+_snapshot_get (NMConnection *live)
+{
+	ConnectionSnapshotData *data;
+
+	nm_assert (NM_IS_CONNECTION (live));
+
+	data = g_object_get_qdata (G_OBJECT (live), _snapshot_quark ());
+	if (data)
+		return g_object_ref (data->snapshot);
+
+	data = g_slice_new (ConnectionSnapshotData);
+	data->live = live;
+	data->snapshot = nm_simple_connection_new_clone (live);
+	g_object_weak_ref (G_OBJECT (data->snapshot), _snapshot_weak_notify_cb, data);
+	g_signal_connect (live, NM_CONNECTION_CHANGED, G_CALLBACK (_snapshot_live_changed_cb), data);
+	g_signal_connect (live, NM_CONNECTION_SECRETS_UPDATED, G_CALLBACK (_snapshot_live_secrets_updated_cb), data);
+	g_signal_connect (live, NM_CONNECTION_SECRETS_CLEARED, G_CALLBACK (_snapshot_live_changed_cb), data);
+	g_object_set_qdata_full (G_OBJECT (live), _snapshot_quark (), data, _snapshot_data_free);
+	return data->snapshot;
+}
+
+/* Returns %TRUE if @snapshot was taken from @live and @live did not change
+ * since. In that case, they are known to be identical without comparing. */
+static gboolean
+_snapshot_is_current (NMConnection *live, NMConnection *snapshot)
+{
+	ConnectionSnapshotData *data;
+
+	data = g_object_get_qdata (G_OBJECT (live), _snapshot_quark ());
+	return data && data->snapshot == snapshot;
+}
+
+/*****************************************************************************/
+
 void
 nm_checkpoint_log_destroy (NMCheckpoint *self)
 {
@@ -173,20 +272,28 @@ find_settings_connection (NMCheckpoint *self,
 		return NULL;
 
 	/* Now check if the connection changed, ... */
-	if (!nm_connection_compare (dev_checkpoint->settings_connection,
-	                            nm_settings_connection_get_connection (sett_conn),
-	                            NM_SETTING_COMPARE_FLAG_EXACT)) {
+	if (   !_snapshot_is_current (nm_settings_connection_get_connection (sett_conn),
+	                              dev_checkpoint->settings_connection)
+	    && !nm_connection_compare (dev_checkpoint->settings_connection,
+	                               nm_settings_connection_get_connection (sett_conn),
+	                               NM_SETTING_COMPARE_FLAG_EXACT)) {
 		_LOGT ("rollback: settings connection %s changed", uuid);
 		*need_update = TRUE;
 		*need_activation = TRUE;
 	}
 
 	/* ... is active, ... */
-	nm_manager_for_each_active_connection (priv->manager, active, tmp_clist) {
-		ac_uuid = nm_settings_connection_get_uuid (nm_active_connection_get_settings_connection (active));
-		if (nm_streq (uuid, ac_uuid)) {
-			_LOGT ("rollback: connection %s is active", uuid);
-			break;
+	active = (NMActiveConnection *) nm_device_get_act_request (dev_checkpoint->device);
+	if (   active
+	    && nm_active_connection_get_settings_connection (active) == sett_conn)
+		_LOGT ("rollback: connection %s is active on the device", uuid);
+	else {
+		nm_manager_for_each_active_connection (priv->manager, active, tmp_clist) {
+			ac_uuid = nm_settings_connection_get_uuid (nm_active_connection_get_settings_connection (active));
+			if (nm_streq (uuid, ac_uuid)) {
+				_LOGT ("rollback: connection %s is active", uuid);
+				break;
+			}
 		}
 	}
 
@@ -313,10 +420,17 @@ activate:
 			}
 
 			if (need_activation) {
+				gs_unref_object NMConnection *applied_clone = NULL;
+
 				_LOGD ("rollback: reactivating connection %s",
 				       nm_settings_connection_get_uuid (connection));
 				subject = nm_auth_subject_new_internal ();
 
+				/* the snapshot may be shared with other checkpoints, while the
+				 * active connection takes ownership of the applied connection
+				 * and modifies it. */
+				applied_clone = nm_simple_connection_new_clone (dev_checkpoint->applied_connection);
+
 				/* Disconnect the device if needed. This necessary because now
 				 * the manager prevents the reactivation of the same connection by
 				 * an internal subject. */
@@ -329,7 +443,7 @@ activate:
 
 				if (!nm_manager_activate_connection (priv->manager,
 				                                     connection,
-				                                     dev_checkpoint->applied_connection,
+				                                     applied_clone,
 				                                     NULL,
 				                                     device,
 				                                     subject,
@@ -435,8 +549,8 @@ device_checkpoint_create (NMDevice *device)
 		settings_connection = nm_act_request_get_settings_connection (act_request);
 		applied_connection = nm_act_request_get_applied_connection (act_request);
 
-		dev_checkpoint->applied_connection = nm_simple_connection_new_clone (applied_connection);
-		dev_checkpoint->settings_connection = nm_simple_connection_new_clone (nm_settings_connection_get_connection (settings_connection));
+		dev_checkpoint->applied_connection = _snapshot_get (applied_connection);
+		dev_checkpoint->settings_connection = _snapshot_get (nm_settings_connection_get_connection (settings_connection));
 		dev_checkpoint->ac_version_id = nm_active_connection_version_id_get (NM_ACTIVE_CONNECTION (act_request));
 		dev_checkpoint->activation_reason = nm_active_connection_get_activation_reason (NM_ACTIVE_CONNECTION (act_request));
 	}
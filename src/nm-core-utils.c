@@ -3937,3 +3937,95 @@ NM_UTILS_LOOKUP_STR_DEFINE (nm_activation_type_to_string, NMActivationType,
 	NM_UTILS_LOOKUP_STR_ITEM (NM_ACTIVATION_TYPE_ASSUME,   "assume"),
 	NM_UTILS_LOOKUP_STR_ITEM (NM_ACTIVATION_TYPE_EXTERNAL, "external"),
 )
+
+/*****************************************************************************/
+
+guint _nm_utils_alive_counters[_NM_UTILS_ALIVE_COUNTER_NUM];
+
+NM_UTILS_LOOKUP_STR_DEFINE (nm_utils_alive_counter_to_string, NMUtilsAliveCounter,
+	NM_UTILS_LOOKUP_DEFAULT_WARN (NULL),
+	NM_UTILS_LOOKUP_STR_ITEM (NM_UTILS_ALIVE_COUNTER_DEVICE,              "devices"),
+	NM_UTILS_LOOKUP_STR_ITEM (NM_UTILS_ALIVE_COUNTER_IP4_CONFIG,          "ip4-configs"),
+	NM_UTILS_LOOKUP_STR_ITEM (NM_UTILS_ALIVE_COUNTER_IP6_CONFIG,          "ip6-configs"),
+	NM_UTILS_LOOKUP_STR_ITEM (NM_UTILS_ALIVE_COUNTER_SETTINGS_CONNECTION, "settings-connections"),
+	NM_UTILS_LOOKUP_ITEM_IGNORE (_NM_UTILS_ALIVE_COUNTER_NUM),
+)
+
+/*****************************************************************************/
+
+typedef struct {
+	guint64 count;
+	guint64 total_ns;
+	guint64 max_ns;
+	guint64 buckets[NM_LATENCY_HISTOGRAM_BUCKETS];
+} LatencyHistogram;
+
+static LatencyHistogram _latency_histograms[_NM_LATENCY_POINT_NUM];
+
+NM_UTILS_LOOKUP_STR_DEFINE_STATIC (_latency_point_to_string, NMLatencyPoint,
+	NM_UTILS_LOOKUP_DEFAULT_WARN (NULL),
+	NM_UTILS_LOOKUP_STR_ITEM (NM_LATENCY_POINT_NETLINK_EVENT,            "netlink-event"),
+	NM_UTILS_LOOKUP_STR_ITEM (NM_LATENCY_POINT_PLATFORM_CACHE_CHANGE,    "platform-cache-change"),
+	NM_UTILS_LOOKUP_STR_ITEM (NM_LATENCY_POINT_DBUS_METHOD_CALL,         "dbus-method-call"),
+	NM_UTILS_LOOKUP_STR_ITEM (NM_LATENCY_POINT_DEVICE_ACTIVATION_STAGE,  "device-activation-stage"),
+	NM_UTILS_LOOKUP_STR_ITEM (NM_LATENCY_POINT_DNS_UPDATE,               "dns-update"),
+	NM_UTILS_LOOKUP_STR_ITEM (NM_LATENCY_POINT_SETTINGS_WRITE,           "settings-write"),
+	NM_UTILS_LOOKUP_ITEM_IGNORE (_NM_LATENCY_POINT_NUM),
+)
+
+/**
+ * nm_latency_record:
+ * @point: the measured code path
+ * @start_ns: the nm_utils_get_monotonic_timestamp_ns() timestamp when
+ *   the code path was entered
+ *
+ * Adds the time since @start_ns to the histogram of @point.
+ */
+void
+nm_latency_record (NMLatencyPoint point, gint64 start_ns)
+{
+	LatencyHistogram *h;
+	gint64 now_ns;
+	guint64 duration;
+
+	nm_assert (point < _NM_LATENCY_POINT_NUM);
+
+	now_ns = nm_utils_get_monotonic_timestamp_ns ();
+	duration = now_ns > start_ns ? (guint64) (now_ns - start_ns) : 0;
+
+	h = &_latency_histograms[point];
+	h->count++;
+	h->total_ns += duration;
+	h->max_ns = MAX (h->max_ns, duration);
+	h->buckets[nm_latency_bucket_index (duration)]++;
+}
+
+/**
+ * nm_latency_stats_to_variant:
+ *
+ * Returns: (transfer floating): a dictionary of type "a{s(tttat)}", with
+ *   the number of measurements, the total and the maximal duration in
+ *   nanoseconds and the histogram buckets for each measured code path.
+ */
+GVariant *
+nm_latency_stats_to_variant (void)
+{
+	GVariantBuilder builder;
+	NMLatencyPoint point;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{s(tttat)}"));
+	for (point = 0; point < _NM_LATENCY_POINT_NUM; point++) {
+		const LatencyHistogram *h = &_latency_histograms[point];
+
+		g_variant_builder_add (&builder, "{s(ttt@at)}",
+		                       _latency_point_to_string (point),
+		                       h->count,
+		                       h->total_ns,
+		                       h->max_ns,
+		                       g_variant_new_fixed_array (G_VARIANT_TYPE_UINT64,
+		                                                  h->buckets,
+		                                                  G_N_ELEMENTS (h->buckets),
+		                                                  sizeof (guint64)));
+	}
+	return g_variant_builder_end (&builder);
+}
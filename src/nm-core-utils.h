@@ -443,4 +443,102 @@ const char *nm_activation_type_to_string (NMActivationType activation_type);
 
 const char *nm_utils_parse_dns_domain (const char *domain, gboolean *is_routing);
 
+/*****************************************************************************/
+
+/* Counters of live instances of certain types, to find leaks and growth
+ * of the daemon's memory usage. See GetMemoryStats on D-Bus. */
+typedef enum {
+	NM_UTILS_ALIVE_COUNTER_DEVICE,
+	NM_UTILS_ALIVE_COUNTER_IP4_CONFIG,
+	NM_UTILS_ALIVE_COUNTER_IP6_CONFIG,
+	NM_UTILS_ALIVE_COUNTER_SETTINGS_CONNECTION,
+	_NM_UTILS_ALIVE_COUNTER_NUM,
+} NMUtilsAliveCounter;
+
+extern guint _nm_utils_alive_counters[_NM_UTILS_ALIVE_COUNTER_NUM];
+
+static inline void
+nm_utils_alive_counter_inc (NMUtilsAliveCounter counter)
+{
+	nm_assert (counter < _NM_UTILS_ALIVE_COUNTER_NUM);
+	_nm_utils_alive_counters[counter]++;
+}
+
+static inline void
+nm_utils_alive_counter_dec (NMUtilsAliveCounter counter)
+{
+	nm_assert (counter < _NM_UTILS_ALIVE_COUNTER_NUM);
+	nm_assert (_nm_utils_alive_counters[counter] > 0);
+	_nm_utils_alive_counters[counter]--;
+}
+
+static inline guint
+nm_utils_alive_counter_get (NMUtilsAliveCounter counter)
+{
+	nm_assert (counter < _NM_UTILS_ALIVE_COUNTER_NUM);
+	return _nm_utils_alive_counters[counter];
+}
+
+const char *nm_utils_alive_counter_to_string (NMUtilsAliveCounter counter);
+
+/*****************************************************************************/
+
+/* Latency histograms for hot paths of the daemon. Configure with
+ * --disable-latency-stats (-Dlatency_stats=false) to compile out the
+ * measurements. */
+#ifndef NM_LATENCY_STATS
+#define NM_LATENCY_STATS 1
+#endif
+
+typedef enum {
+	NM_LATENCY_POINT_NETLINK_EVENT,
+	NM_LATENCY_POINT_PLATFORM_CACHE_CHANGE,
+	NM_LATENCY_POINT_DBUS_METHOD_CALL,
+	NM_LATENCY_POINT_DEVICE_ACTIVATION_STAGE,
+	NM_LATENCY_POINT_DNS_UPDATE,
+	NM_LATENCY_POINT_SETTINGS_WRITE,
+	_NM_LATENCY_POINT_NUM,
+} NMLatencyPoint;
+
+/* bucket i counts durations of i significant bits, that is
+ * [2^(i-1), 2^i) nanoseconds. The last bucket takes all longer ones. */
+#define NM_LATENCY_HISTOGRAM_BUCKETS 40
+
+static inline guint
+nm_latency_bucket_index (guint64 duration_ns)
+{
+	guint idx;
+
+	idx = duration_ns ? (64 - __builtin_clzll (duration_ns)) : 0;
+	return MIN (idx, (guint) (NM_LATENCY_HISTOGRAM_BUCKETS - 1));
+}
+
+void nm_latency_record (NMLatencyPoint point, gint64 start_ns);
+
+GVariant *nm_latency_stats_to_variant (void);
+
+typedef struct {
+	gint64 start_ns;
+	NMLatencyPoint point;
+} NMLatencyMeasure;
+
+static inline void
+_nm_latency_measure_done (NMLatencyMeasure *measure)
+{
+	nm_latency_record (measure->point, measure->start_ns);
+}
+
+/* Declares a variable that measures the time until the end of the
+ * enclosing scope. Use it among the declarations at the start of a block. */
+#if NM_LATENCY_STATS
+#define nm_latency_measure_scope(latency_point) \
+	nm_auto (_nm_latency_measure_done) NMLatencyMeasure NM_UNIQ_T (latency_measure, NM_UNIQ) G_GNUC_UNUSED = { \
+		.start_ns = nm_utils_get_monotonic_timestamp_ns (), \
+		.point    = (latency_point), \
+	}
+#else
+#define nm_latency_measure_scope(latency_point) \
+	G_GNUC_UNUSED const NMLatencyPoint NM_UNIQ_T (latency_measure, NM_UNIQ) = (latency_point)
+#endif
+
 #endif /* __NM_CORE_UTILS_H__ */
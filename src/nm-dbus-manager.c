@@ -796,6 +796,7 @@ dbus_vtable_method_call (GDBusConnection *connection,
 	const NMDBusInterfaceInfoExtended *interface_info = _reg_data_get_interface_info (reg_data);
 	const NMDBusMethodInfoExtended *method_info = NULL;
 	gboolean on_same_interface;
+	nm_latency_measure_scope (NM_LATENCY_POINT_DBUS_METHOD_CALL);
 
 	on_same_interface = nm_streq (interface_info->parent.name, interface_name);
 
@@ -25,6 +25,7 @@
 
 #include <string.h>
 #include <errno.h>
+#include <sys/stat.h>
 
 #include "nm-dispatcher-api.h"
 #include "NetworkManagerUtils.h"
@@ -934,6 +935,53 @@ nm_dispatcher_call_cancel (guint call_id)
 	}
 }
 
+/* Whether nm-dispatcher might run @name from @dirname. This mirrors the
+ * filename and permission checks that the dispatcher service applies when
+ * collecting scripts, so that sub-directories (like "no-wait.d") and backup
+ * files don't force us to build and send a request that would end up running
+ * nothing.
+ *
+ * Symlinks are always counted without looking at their target: we only monitor
+ * @dirname itself, so we wouldn't notice when a target (usually in "no-wait.d")
+ * appears or changes its permissions later. */
+gboolean
+nm_dispatcher_script_is_runnable (const char *dirname, const char *name)
+{
+	static const char *const bad_suffixes[] = {
+		"~",
+		".rpmsave",
+		".rpmorig",
+		".rpmnew",
+		".swp",
+	};
+	gs_free char *path = NULL;
+	struct stat st;
+	const char *tmp;
+	guint i;
+	NM_AUTO_PROTECT_ERRNO (errsv_saved);
+
+	if (name[0] == '.')
+		return FALSE;
+	for (i = 0; i < G_N_ELEMENTS (bad_suffixes); i++) {
+		if (g_str_has_suffix (name, bad_suffixes[i]))
+			return FALSE;
+	}
+	tmp = g_strrstr (name, ".dpkg-");
+	if (tmp && !strchr (&tmp[1], '.'))
+		return FALSE;
+
+	path = g_build_filename (dirname, name, NULL);
+	if (lstat (path, &st) != 0)
+		return FALSE;
+	if (S_ISLNK (st.st_mode))
+		return TRUE;
+
+	return    S_ISREG (st.st_mode)
+	       && st.st_uid == 0
+	       && !(st.st_mode & (S_IWGRP | S_IWOTH | S_ISUID))
+	       && !!(st.st_mode & S_IXUSR);
+}
+
 static void
 dispatcher_dir_changed (GFileMonitor *monitor,
                         GFile *file,
@@ -942,7 +990,6 @@ dispatcher_dir_changed (GFileMonitor *monitor,
                         Monitor *item)
 {
 	const char *name;
-	char *full_name;
 	GDir *dir;
 	GError *error = NULL;
 
@@ -953,11 +1000,8 @@ dispatcher_dir_changed (GFileMonitor *monitor,
 		item->has_scripts = FALSE;
 		errno = 0;
 		while (!item->has_scripts
-		    && (name = g_dir_read_name (dir))) {
-			full_name = g_build_filename (item->dir, name, NULL);
-			item->has_scripts = g_file_test (full_name, G_FILE_TEST_IS_EXECUTABLE);
-			g_free (full_name);
-		}
+		    && (name = g_dir_read_name (dir)))
+			item->has_scripts = nm_dispatcher_script_is_runnable (item->dir, name);
 		errsv = errno;
 		g_dir_close (dir);
 		if (item->has_scripts)
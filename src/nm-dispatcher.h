@@ -86,4 +86,6 @@ void nm_dispatcher_call_cancel (guint call_id);
 
 void nm_dispatcher_init (void);
 
+gboolean nm_dispatcher_script_is_runnable (const char *dirname, const char *name);
+
 #endif /* __NM_DISPATCHER_H__ */
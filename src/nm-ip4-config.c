@@ -3259,6 +3259,8 @@ nm_ip4_config_init (NMIP4Config *self)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
+	nm_utils_alive_counter_inc (NM_UTILS_ALIVE_COUNTER_IP4_CONFIG);
+
 	nm_ip_config_dedup_multi_idx_type_init ((NMIPConfigDedupMultiIdxType *) &priv->idx_ip4_addresses,
 	                                        NMP_OBJECT_TYPE_IP4_ADDRESS);
 	nm_ip_config_dedup_multi_idx_type_init ((NMIPConfigDedupMultiIdxType *) &priv->idx_ip4_routes,
@@ -3290,6 +3292,8 @@ finalize (GObject *object)
 	NMIP4Config *self = NM_IP4_CONFIG (object);
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (self);
 
+	nm_utils_alive_counter_dec (NM_UTILS_ALIVE_COUNTER_IP4_CONFIG);
+
 	nm_clear_nmp_object (&priv->best_default_route);
 
 	nm_dedup_multi_index_remove_idx (priv->multi_idx, &priv->idx_ip4_addresses);
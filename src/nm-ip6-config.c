@@ -2716,6 +2716,8 @@ nm_ip6_config_init (NMIP6Config *self)
 {
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
+	nm_utils_alive_counter_inc (NM_UTILS_ALIVE_COUNTER_IP6_CONFIG);
+
 	nm_ip_config_dedup_multi_idx_type_init ((NMIPConfigDedupMultiIdxType *) &priv->idx_ip6_addresses,
 	                                        NMP_OBJECT_TYPE_IP6_ADDRESS);
 	nm_ip_config_dedup_multi_idx_type_init ((NMIPConfigDedupMultiIdxType *) &priv->idx_ip6_routes,
@@ -2756,6 +2758,8 @@ finalize (GObject *object)
 	NMIP6Config *self = NM_IP6_CONFIG (object);
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (self);
 
+	nm_utils_alive_counter_dec (NM_UTILS_ALIVE_COUNTER_IP6_CONFIG);
+
 	nm_clear_nmp_object (&priv->best_default_route);
 
 	nm_dedup_multi_index_remove_idx (priv->multi_idx, &priv->idx_ip6_addresses);
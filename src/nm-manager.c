@@ -1061,6 +1061,20 @@ _get_activatable_connections_filter (NMSettings *settings,
 	                                NULL);
 }
 
+gboolean
+nm_manager_connection_is_activatable (NMManager *manager,
+                                      NMSettingsConnection *sett_conn,
+                                      gboolean for_auto_activation)
+{
+	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (manager);
+	const GetActivatableConnectionsFilterData d = {
+		.self = manager,
+		.for_auto_activation = for_auto_activation,
+	};
+
+	return _get_activatable_connections_filter (priv->settings, sett_conn, (gpointer) &d);
+}
+
 NMSettingsConnection **
 nm_manager_get_activatable_connections (NMManager *manager,
                                         gboolean for_auto_activation,
@@ -5949,6 +5963,61 @@ impl_manager_get_logging (NMDBusObject *obj,
 	                                                      nm_logging_domains_to_string ()));
 }
 
+static void
+impl_manager_get_memory_stats (NMDBusObject *obj,
+                               const NMDBusInterfaceInfoExtended *interface_info,
+                               const NMDBusMethodInfoExtended *method_info,
+                               GDBusConnection *connection,
+                               const char *sender,
+                               GDBusMethodInvocation *invocation,
+                               GVariant *parameters)
+{
+	NMManager *self = NM_MANAGER (obj);
+	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (self);
+	GVariantBuilder builder;
+	NMPObjectType obj_type;
+	NMUtilsAliveCounter counter;
+	guint n_entries;
+	guint n_objs;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{su}"));
+
+	for (counter = 0; counter < _NM_UTILS_ALIVE_COUNTER_NUM; counter++) {
+		g_variant_builder_add (&builder, "{su}",
+		                       nm_utils_alive_counter_to_string (counter),
+		                       nm_utils_alive_counter_get (counter));
+	}
+
+	for (obj_type = NMP_OBJECT_TYPE_UNKNOWN + 1; obj_type <= NMP_OBJECT_TYPE_MAX; obj_type++) {
+		char key[100];
+
+		g_variant_builder_add (&builder, "{su}",
+		                       nm_sprintf_buf (key, "platform-objects.%s", nmp_class_from_type (obj_type)->obj_type_name),
+		                       nmp_object_get_alive_count (obj_type));
+	}
+
+	nm_dedup_multi_index_get_stats (nm_platform_get_multi_idx (priv->platform), &n_entries, &n_objs);
+	g_variant_builder_add (&builder, "{su}", "dedup-index.entries", n_entries);
+	g_variant_builder_add (&builder, "{su}", "dedup-index.objects", n_objs);
+
+	g_dbus_method_invocation_return_value (invocation,
+	                                       g_variant_new ("(a{su})", &builder));
+}
+
+static void
+impl_manager_get_latency_stats (NMDBusObject *obj,
+                                const NMDBusInterfaceInfoExtended *interface_info,
+                                const NMDBusMethodInfoExtended *method_info,
+                                GDBusConnection *connection,
+                                const char *sender,
+                                GDBusMethodInvocation *invocation,
+                                GVariant *parameters)
+{
+	g_dbus_method_invocation_return_value (invocation,
+	                                       g_variant_new ("(@a{s(tttat)})",
+	                                                      nm_latency_stats_to_variant ()));
+}
+
 typedef struct {
 	NMManager *self;
 	GDBusMethodInvocation *context;
@@ -7568,6 +7637,24 @@ static const NMDBusInterfaceInfoExtended interface_info_manager = {
 				),
 				.handle = impl_manager_get_logging,
 			),
+			NM_DEFINE_DBUS_METHOD_INFO_EXTENDED (
+				NM_DEFINE_GDBUS_METHOD_INFO_INIT (
+					"GetMemoryStats",
+					.out_args = NM_DEFINE_GDBUS_ARG_INFOS (
+						NM_DEFINE_GDBUS_ARG_INFO ("stats", "a{su}"),
+					),
+				),
+				.handle = impl_manager_get_memory_stats,
+			),
+			NM_DEFINE_DBUS_METHOD_INFO_EXTENDED (
+				NM_DEFINE_GDBUS_METHOD_INFO_INIT (
+					"GetLatencyStats",
+					.out_args = NM_DEFINE_GDBUS_ARG_INFOS (
+						NM_DEFINE_GDBUS_ARG_INFO ("stats", "a{s(tttat)}"),
+					),
+				),
+				.handle = impl_manager_get_latency_stats,
+			),
 			NM_DEFINE_DBUS_METHOD_INFO_EXTENDED (
 				NM_DEFINE_GDBUS_METHOD_INFO_INIT (
 					"CheckConnectivity",
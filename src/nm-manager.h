@@ -97,6 +97,10 @@ const CList * nm_manager_get_active_connections        (NMManager *manager);
 	    }); \
 	    iter = c_list_entry (iter->active_connections_lst.next, NMActiveConnection, active_connections_lst))
 
+gboolean nm_manager_connection_is_activatable (NMManager *manager,
+                                               NMSettingsConnection *sett_conn,
+                                               gboolean for_auto_activation);
+
 NMSettingsConnection **nm_manager_get_activatable_connections (NMManager *manager,
                                                                gboolean for_auto_activation,
                                                                gboolean sort,
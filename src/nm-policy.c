@@ -73,6 +73,11 @@ typedef struct {
 	GHashTable *devices;
 	GHashTable *pending_active_connections;
 
+	/* The connections that have autoconnect enabled, grouped by their
+	 * connection type. Built on demand and dropped whenever a connection
+	 * is added, updated or removed. */
+	GHashTable *autoconnect_candidates;
+
 	GSList *pending_secondaries;
 
 	NMSettings *settings;
@@ -95,6 +100,14 @@ typedef struct {
 
 	guint schedule_activate_all_id; /* idle handler for schedule_activate_all(). */
 
+	/* idle handler for coalescing the updates of routing, DNS and hostname
+	 * after IP config changes. While it is pending, a DNS update batch is open. */
+	guint ip_config_update_id;
+	bool ip_config_dirty_4:1;
+	bool ip_config_dirty_6:1;
+	guint ip_config_changes;
+	guint ip_config_updates;
+
 	NMPolicyHostnameMode hostname_mode;
 	char *orig_hostname; /* hostname at NM start time */
 	char *cur_hostname;  /* hostname we want to assign */
@@ -1107,6 +1120,17 @@ update_ip_dns (NMPolicy *self, int addr_family)
 		update_ip6_dns_delegation (self);
 }
 
+static void
+ip_config_update_clear (NMPolicy *self)
+{
+	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (self);
+
+	if (nm_clear_g_source (&priv->ip_config_update_id))
+		nm_dns_manager_end_updates (priv->dns_manager, __func__);
+	priv->ip_config_dirty_4 = FALSE;
+	priv->ip_config_dirty_6 = FALSE;
+}
+
 static void
 update_routing_and_dns (NMPolicy *self, gboolean force_update)
 {
@@ -1114,6 +1138,10 @@ update_routing_and_dns (NMPolicy *self, gboolean force_update)
 
 	nm_dns_manager_begin_updates (priv->dns_manager, __func__);
 
+	/* a forced update covers any pending update after IP config changes. */
+	if (force_update)
+		ip_config_update_clear (self);
+
 	update_ip_dns (self, AF_INET);
 	update_ip_dns (self, AF_INET6);
 
@@ -1207,6 +1235,71 @@ pending_ac_state_changed (NMActiveConnection *ac, guint state, guint reason, NMP
 	}
 }
 
+static void
+autoconnect_candidates_clear (NMPolicy *self)
+{
+	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (self);
+
+	nm_clear_pointer (&priv->autoconnect_candidates, g_hash_table_unref);
+}
+
+static GHashTable *
+autoconnect_candidates_get (NMPolicy *self)
+{
+	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (self);
+	NMSettingsConnection *const*connections;
+	guint i, len;
+
+	if (G_LIKELY (priv->autoconnect_candidates))
+		return priv->autoconnect_candidates;
+
+	priv->autoconnect_candidates = g_hash_table_new_full (nm_str_hash, g_str_equal,
+	                                                      g_free, (GDestroyNotify) g_ptr_array_unref);
+
+	connections = nm_settings_get_connections (priv->settings, &len);
+	for (i = 0; i < len; i++) {
+		NMSettingConnection *s_con;
+		const char *type;
+		GPtrArray *arr;
+
+		s_con = nm_connection_get_setting_connection (nm_settings_connection_get_connection (connections[i]));
+		if (!nm_setting_connection_get_autoconnect (s_con))
+			continue;
+
+		type = nm_setting_connection_get_connection_type (s_con);
+		if (!type)
+			continue;
+
+		arr = g_hash_table_lookup (priv->autoconnect_candidates, type);
+		if (!arr) {
+			arr = g_ptr_array_new_with_free_func (g_object_unref);
+			g_hash_table_insert (priv->autoconnect_candidates, g_strdup (type), arr);
+		}
+		g_ptr_array_add (arr, g_object_ref (connections[i]));
+	}
+
+	return priv->autoconnect_candidates;
+}
+
+static void
+autoconnect_candidates_collect (NMPolicy *self,
+                                GPtrArray *arr,
+                                GPtrArray *result)
+{
+	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (self);
+	guint i;
+
+	for (i = 0; i < arr->len; i++) {
+		NMSettingsConnection *candidate = arr->pdata[i];
+
+		if (nm_settings_connection_autoconnect_is_blocked (candidate))
+			continue;
+		if (!nm_manager_connection_is_activatable (priv->manager, candidate, TRUE))
+			continue;
+		g_ptr_array_add (result, candidate);
+	}
+}
+
 static void
 auto_activate_device (NMPolicy *self,
                       NMDevice *device)
@@ -1214,8 +1307,10 @@ auto_activate_device (NMPolicy *self,
 	NMPolicyPrivate *priv;
 	NMSettingsConnection *best_connection;
 	gs_free char *specific_object = NULL;
-	gs_free NMSettingsConnection **connections = NULL;
-	guint i, len;
+	gs_unref_ptrarray GPtrArray *connections = NULL;
+	GHashTable *candidates;
+	const char *type;
+	guint i;
 	gs_free_error GError *error = NULL;
 	gs_unref_object NMAuthSubject *subject = NULL;
 	NMActiveConnection *ac;
@@ -1235,27 +1330,43 @@ auto_activate_device (NMPolicy *self,
 	if (!nm_device_autoconnect_allowed (device))
 		return;
 
-	connections = nm_manager_get_activatable_connections (priv->manager, TRUE, TRUE, &len);
-	if (!connections[0])
+	candidates = autoconnect_candidates_get (self);
+	connections = g_ptr_array_new ();
+
+	/* Devices that only support one connection type need to look only at
+	 * the candidates of that type. */
+	type = NM_DEVICE_GET_CLASS (device)->connection_type_check_compatible;
+	if (type) {
+		GPtrArray *arr;
+
+		arr = g_hash_table_lookup (candidates, type);
+		if (arr)
+			autoconnect_candidates_collect (self, arr, connections);
+	} else {
+		GHashTableIter iter;
+		GPtrArray *arr;
+
+		g_hash_table_iter_init (&iter, candidates);
+		while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &arr))
+			autoconnect_candidates_collect (self, arr, connections);
+	}
+
+	if (connections->len == 0)
 		return;
 
+	g_ptr_array_sort_with_data (connections,
+	                            nm_settings_connection_cmp_autoconnect_priority_p_with_data,
+	                            NULL);
+
 	/* Find the first connection that should be auto-activated */
 	best_connection = NULL;
-	for (i = 0; i < len; i++) {
-		NMSettingsConnection *candidate = connections[i];
+	for (i = 0; i < connections->len; i++) {
+		NMSettingsConnection *candidate = connections->pdata[i];
 		NMConnection *cand_conn;
-		NMSettingConnection *s_con;
 		const char *permission;
 
-		if (nm_settings_connection_autoconnect_is_blocked (candidate))
-			continue;
-
 		cand_conn = nm_settings_connection_get_connection (candidate);
 
-		s_con = nm_connection_get_setting_connection (cand_conn);
-		if (!nm_setting_connection_get_autoconnect (s_con))
-			continue;
-
 		permission = nm_utils_get_shared_wifi_permission (cand_conn);
 		if (   permission
 		    && !nm_settings_connection_check_permission (candidate, permission))
@@ -1944,6 +2055,63 @@ device_state_changed (NMDevice *device,
 	check_activating_active_connections (self);
 }
 
+static gboolean
+ip_config_update_cb (gpointer user_data)
+{
+	NMPolicy *self = user_data;
+	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (self);
+	gboolean dirty_4 = priv->ip_config_dirty_4;
+	gboolean dirty_6 = priv->ip_config_dirty_6;
+
+	priv->ip_config_update_id = 0;
+	priv->ip_config_dirty_4 = FALSE;
+	priv->ip_config_dirty_6 = FALSE;
+	priv->ip_config_updates++;
+
+	_LOGT (LOGD_CORE, "update routing and DNS after IP config changes (%u changes, %u updates so far)",
+	       priv->ip_config_changes, priv->ip_config_updates);
+
+	if (dirty_4) {
+		update_ip_dns (self, AF_INET);
+		update_ip4_routing (self, TRUE);
+	}
+	if (dirty_6) {
+		update_ip_dns (self, AF_INET6);
+		update_ip6_routing (self, TRUE);
+	}
+	update_system_hostname (self,
+	                        dirty_4 && dirty_6
+	                          ? "ip conf"
+	                          : (dirty_4 ? "ip4 conf" : "ip6 conf"));
+
+	/* close the DNS update batch opened by ip_config_update_schedule(). */
+	nm_dns_manager_end_updates (priv->dns_manager, __func__);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+ip_config_update_schedule (NMPolicy *self, int addr_family)
+{
+	NMPolicyPrivate *priv = NM_POLICY_GET_PRIVATE (self);
+
+	priv->ip_config_changes++;
+
+	if (addr_family == AF_INET)
+		priv->ip_config_dirty_4 = TRUE;
+	else
+		priv->ip_config_dirty_6 = TRUE;
+
+	if (priv->ip_config_update_id)
+		return;
+
+	/* Devices can change their IP configs many times in a row, for example
+	 * during a mass activation. Evaluate the best devices, routing, DNS and
+	 * hostname only once for all the changes. Keep the DNS update batch open
+	 * until then, so that the DNS configuration is also written only once. */
+	nm_dns_manager_begin_updates (priv->dns_manager, __func__);
+	priv->ip_config_update_id = g_idle_add (ip_config_update_cb, self);
+}
+
 static void
 device_ip_config_changed (NMDevice *device,
                           NMIPConfig *new_config,
@@ -1978,15 +2146,7 @@ device_ip_config_changed (NMDevice *device,
 			if (old_config)
 				nm_dns_manager_set_ip_config (priv->dns_manager, old_config, NM_DNS_IP_CONFIG_TYPE_REMOVED);
 		}
-		update_ip_dns (self, addr_family);
-		if (addr_family == AF_INET)
-			update_ip4_routing (self, TRUE);
-		else
-			update_ip6_routing (self, TRUE);
-		update_system_hostname (self,
-		                        addr_family == AF_INET
-		                          ? "ip4 conf"
-		                          : "ip6 conf");
+		ip_config_update_schedule (self, addr_family);
 	} else {
 		/* Old configs get removed immediately */
 		if (old_config)
@@ -2260,6 +2420,7 @@ connection_added (NMSettings *settings,
 	NMPolicyPrivate *priv = user_data;
 	NMPolicy *self = _PRIV_TO_SELF (priv);
 
+	autoconnect_candidates_clear (self);
 	schedule_activate_all (self);
 }
 
@@ -2334,6 +2495,8 @@ connection_updated (NMSettings *settings,
 	NMDevice *device = NULL;
 	NMDevice *dev;
 
+	autoconnect_candidates_clear (self);
+
 	if (by_user) {
 		/* find device with given connection */
 		nm_manager_for_each_device (priv->manager, dev, tmp_lst) {
@@ -2389,6 +2552,7 @@ connection_removed (NMSettings *settings,
 	NMPolicyPrivate *priv = user_data;
 	NMPolicy *self = _PRIV_TO_SELF (priv);
 
+	autoconnect_candidates_clear (self);
 	_deactivate_if_active (self, connection);
 }
 
@@ -2622,6 +2786,7 @@ dispose (GObject *object)
 	nm_clear_g_object (&priv->activating_ac4);
 	nm_clear_g_object (&priv->activating_ac6);
 	g_clear_pointer (&priv->pending_active_connections, g_hash_table_unref);
+	g_clear_pointer (&priv->autoconnect_candidates, g_hash_table_unref);
 
 	c_list_for_each_entry_safe (data, data_safe, &priv->pending_activation_checks, pending_lst)
 		activate_data_free (data);
@@ -2640,6 +2805,7 @@ dispose (GObject *object)
 	}
 
 	if (priv->dns_manager) {
+		ip_config_update_clear (self);
 		nm_clear_g_signal_handler (priv->dns_manager, &priv->config_changed_id);
 		g_clear_object (&priv->dns_manager);
 	}
@@ -372,6 +372,11 @@ typedef struct {
 	bool sysctl_get_warned;
 	GHashTable *sysctl_get_prev_values;
 
+	/* the values of /proc/sys that were written or read during the current
+	 * main loop iteration, to suppress redundant writes. */
+	GHashTable *sysctl_values;
+	guint sysctl_values_clear_id;
+
 	NMUdevClient *udev_client;
 
 	struct {
@@ -3702,6 +3707,72 @@ _log_dbg_sysctl_set_impl (NMPlatform *platform, const char *pathid, int dirfd, c
 		} \
 	} G_STMT_END
 
+/* Setting per-interface sysctls during activation often writes the
+ * same value several times in a row (or writes back a value that was
+ * just read). For plain /proc/sys values, remember what we wrote or read
+ * until the end of the current main loop iteration and skip the
+ * redundant writes. Files in /sys are not remembered, because writing
+ * to them can be an action (like "create_child") that isn't idempotent.
+ *
+ * The remembered values are dropped whenever a link changes, because
+ * the kernel may reset the per-interface sysctls (for example, after
+ * changing the MTU or when recreating an interface with the same
+ * name). */
+static gboolean
+_sysctl_values_is_cacheable (int dirfd, const char *path)
+{
+	return    dirfd < 0
+	       && g_str_has_prefix (path, "/proc/sys/");
+}
+
+static void
+_sysctl_values_clear (NMPlatform *platform)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	nm_clear_g_source (&priv->sysctl_values_clear_id);
+	if (priv->sysctl_values)
+		g_hash_table_remove_all (priv->sysctl_values);
+}
+
+static gboolean
+_sysctl_values_clear_cb (gpointer user_data)
+{
+	NMPlatform *platform = user_data;
+
+	NM_LINUX_PLATFORM_GET_PRIVATE (platform)->sysctl_values_clear_id = 0;
+	_sysctl_values_clear (platform);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_sysctl_values_set (NMPlatform *platform, const char *path, const char *value)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	if (!value) {
+		if (priv->sysctl_values)
+			g_hash_table_remove (priv->sysctl_values, path);
+		return;
+	}
+
+	if (!priv->sysctl_values)
+		priv->sysctl_values = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, g_free);
+	g_hash_table_insert (priv->sysctl_values, g_strdup (path), g_strdup (value));
+
+	if (!priv->sysctl_values_clear_id)
+		priv->sysctl_values_clear_id = g_idle_add (_sysctl_values_clear_cb, platform);
+}
+
+static gboolean
+_sysctl_values_has (NMPlatform *platform, const char *path, const char *value)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	return    priv->sysctl_values
+	       && nm_streq0 (g_hash_table_lookup (priv->sysctl_values, path), value);
+}
+
 static gboolean
 sysctl_set (NMPlatform *platform, const char *pathid, int dirfd, const char *path, const char *value)
 {
@@ -3712,12 +3783,29 @@ sysctl_set (NMPlatform *platform, const char *pathid, int dirfd, const char *pat
 	char *actual;
 	gs_free char *actual_free = NULL;
 	int errsv;
+	gboolean cacheable;
 
 	g_return_val_if_fail (path != NULL, FALSE);
 	g_return_val_if_fail (value != NULL, FALSE);
 
 	ASSERT_SYSCTL_ARGS (pathid, dirfd, path);
 
+	cacheable = _sysctl_values_is_cacheable (dirfd, path);
+	if (cacheable) {
+		if (_sysctl_values_has (platform, path, value)) {
+			_LOGt ("sysctl: setting '%s' to '%s' (skipped, value is unchanged)", path, value);
+			return TRUE;
+		}
+
+		/* toggling disable_ipv6 resets the other IPv6 settings of the
+		 * interface, and writing to "conf/all" propagates to all interfaces. */
+		if (   g_str_has_suffix (path, "/disable_ipv6")
+		    || strstr (path, "/conf/all/"))
+			_sysctl_values_clear (platform);
+		else
+			_sysctl_values_set (platform, path, NULL);
+	}
+
 	if (dirfd < 0) {
 		if (!nm_platform_netns_push (platform, &netns)) {
 			errno = ENETDOWN;
@@ -3819,6 +3907,9 @@ sysctl_set (NMPlatform *platform, const char *pathid, int dirfd, const char *pat
 		return FALSE;
 	}
 
+	if (cacheable)
+		_sysctl_values_set (platform, path, value);
+
 	/* success. errno is undefined (no need to set). */
 	return TRUE;
 }
@@ -3913,6 +4004,9 @@ sysctl_get (NMPlatform *platform, const char *pathid, int dirfd, const char *pat
 
 	_log_dbg_sysctl_get (platform, pathid, contents);
 
+	if (_sysctl_values_is_cacheable (dirfd, path))
+		_sysctl_values_set (platform, path, contents);
+
 	return contents;
 }
 
@@ -4425,6 +4519,7 @@ cache_on_change (NMPlatform *platform,
 	char str_buf[sizeof (_nm_utils_to_string_buffer)];
 	char str_buf2[sizeof (_nm_utils_to_string_buffer)];
 	NMPCache *cache = nm_platform_get_cache (platform);
+	nm_latency_measure_scope (NM_LATENCY_POINT_PLATFORM_CACHE_CHANGE);
 
 	ASSERT_nmp_cache_ops (cache, cache_op, obj_old, obj_new);
 	nm_assert (cache_op != NMP_CACHE_OPS_UNCHANGED);
@@ -4449,6 +4544,9 @@ cache_on_change (NMPlatform *platform,
 	switch (klass->obj_type) {
 	case NMP_OBJECT_TYPE_LINK:
 		{
+			/* the kernel may reset the sysctl values of a link that changes. */
+			_sysctl_values_clear (platform);
+
 			/* check whether changing a slave link can cause a master link (bridge or bond) to go up/down */
 			if (   obj_old
 			    && nmp_cache_link_connected_needs_toggle_by_ifindex (cache, obj_old->link.master, obj_new, obj_old))
@@ -4955,6 +5053,7 @@ event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_event
 	gboolean id_only = FALSE;
 	NMPCache *cache = nm_platform_get_cache (platform);
 	gboolean is_dump;
+	nm_latency_measure_scope (NM_LATENCY_POINT_NETLINK_EVENT);
 
 	msghdr = nlmsg_hdr (msg);
 
@@ -7989,6 +8088,10 @@ finalize (GObject *object)
 		g_hash_table_destroy (priv->sysctl_get_prev_values);
 	}
 
+	nm_clear_g_source (&priv->sysctl_values_clear_id);
+	if (priv->sysctl_values)
+		g_hash_table_destroy (priv->sysctl_values);
+
 	priv->udev_client = nm_udev_client_unref (priv->udev_client);
 
 	G_OBJECT_CLASS (nm_linux_platform_parent_class)->finalize (object);
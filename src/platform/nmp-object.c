@@ -584,6 +584,17 @@ _vt_cmd_obj_dispose_lnk_wireguard (NMPObject *obj)
 	_wireguard_clear (&obj->_lnk_wireguard);
 }
 
+/* number of allocated objects, by NMPObjectType */
+static guint _nmp_object_alive[NMP_OBJECT_TYPE_MAX + 1];
+
+guint
+nmp_object_get_alive_count (NMPObjectType obj_type)
+{
+	g_return_val_if_fail (obj_type > NMP_OBJECT_TYPE_UNKNOWN && obj_type <= NMP_OBJECT_TYPE_MAX, 0);
+
+	return _nmp_object_alive[obj_type];
+}
+
 static NMPObject *
 _nmp_object_new_from_class (const NMPClass *klass)
 {
@@ -596,6 +607,7 @@ _nmp_object_new_from_class (const NMPClass *klass)
 	obj = g_slice_alloc0 (klass->sizeof_data + G_STRUCT_OFFSET (NMPObject, object));
 	obj->_class = klass;
 	obj->parent._ref_count = 1;
+	_nmp_object_alive[klass->obj_type]++;
 	return obj;
 }
 
@@ -1504,6 +1516,8 @@ _vt_dedup_obj_destroy (NMDedupMultiObj *obj)
 	klass = o->_class;
 	if (klass->cmd_obj_dispose)
 		klass->cmd_obj_dispose (o);
+	nm_assert (_nmp_object_alive[klass->obj_type] > 0);
+	_nmp_object_alive[klass->obj_type]--;
 	g_slice_free1 (klass->sizeof_data + G_STRUCT_OFFSET (NMPObject, object), o);
 }
 
@@ -538,6 +538,7 @@ nmp_object_unref (const NMPObject *obj)
 
 NMPObject *nmp_object_new (NMPObjectType obj_type, const NMPlatformObject *plob);
 NMPObject *nmp_object_new_link (int ifindex);
+guint nmp_object_get_alive_count (NMPObjectType obj_type);
 
 const NMPObject *nmp_object_stackinit (NMPObject *obj, NMPObjectType obj_type, gconstpointer plobj);
 
@@ -112,21 +112,29 @@ typedef struct _NMSettingsConnectionPrivate {
 	 * call to nm_connection_clear_secrets() wipes them out and we'd have
 	 * to re-read them from disk which defeats the purpose of having the
 	 * connection in-memory at all.
+	 *
+	 * Only the secrets are kept, as serialized by nm_connection_to_dbus()
+	 * with %NM_CONNECTION_SERIALIZE_ONLY_SECRETS. A full clone of the
+	 * connection would double the memory used by each profile.
 	 */
-	NMConnection *system_secrets;
+	GVariant *system_secrets;
 
 	/* Caches secrets from agents during the activation process; if new system
 	 * secrets are returned from an agent, they get written out to disk,
 	 * triggering a re-read of the connection, which reads only system
 	 * secrets, and would wipe out any agent-owned or not-saved secrets the
-	 * agent also returned.
+	 * agent also returned. Same format as @system_secrets.
 	 */
-	NMConnection *agent_secrets;
+	GVariant *agent_secrets;
 
 	char *filename;
 
 	GHashTable *seen_bssids; /* Up-to-date BSSIDs that's been seen for the connection */
 
+	/* The secret-free result of GetSettings. It also contains the timestamp
+	 * and seen-bssids, so it must be dropped whenever one of them changes. */
+	GVariant *getsettings_cached;
+
 	guint64 timestamp;   /* Up-to-date timestamp of connection use */
 
 	guint64 last_secret_agent_version_id;
@@ -468,36 +476,61 @@ secrets_filter_cb (NMSetting *setting,
 	return (flags & filter_flags) ? FALSE : TRUE;
 }
 
+static GVariant *
+secrets_cache_new (NMConnection *connection, NMSettingSecretFlags filter_flags)
+{
+	gs_unref_object NMConnection *simple = NULL;
+	GVariant *dict;
+
+	simple = nm_simple_connection_new_clone (connection);
+	nm_connection_clear_secrets_with_flags (simple,
+	                                        secrets_filter_cb,
+	                                        GUINT_TO_POINTER (filter_flags));
+	dict = nm_connection_to_dbus (simple, NM_CONNECTION_SERIALIZE_ONLY_SECRETS);
+	return dict ? g_variant_ref_sink (dict) : NULL;
+}
+
+static GVariant *
+secrets_cache_clear (GVariant *dict)
+{
+	GVariantBuilder builder;
+	GVariantIter iter;
+	const char *setting_name;
+
+	/* Keep the (now empty) dictionaries of the settings, like
+	 * nm_connection_to_dbus() does for a connection without secrets. */
+	g_variant_builder_init (&builder, NM_VARIANT_TYPE_CONNECTION);
+	g_variant_iter_init (&iter, dict);
+	while (g_variant_iter_next (&iter, "{&s@a{sv}}", &setting_name, NULL)) {
+		g_variant_builder_add (&builder, "{s@a{sv}}",
+		                       setting_name,
+		                       g_variant_new_array (G_VARIANT_TYPE ("{sv}"), NULL, 0));
+	}
+	return g_variant_ref_sink (g_variant_builder_end (&builder));
+}
+
 static void
 update_system_secrets_cache (NMSettingsConnection *self)
 {
 	NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE (self);
 
-	if (priv->system_secrets)
-		g_object_unref (priv->system_secrets);
-	priv->system_secrets = nm_simple_connection_new_clone (nm_settings_connection_get_connection (self));
+	g_clear_pointer (&priv->system_secrets, g_variant_unref);
 
 	/* Clear out non-system-owned and not-saved secrets */
-	nm_connection_clear_secrets_with_flags (priv->system_secrets,
-	                                        secrets_filter_cb,
-	                                        GUINT_TO_POINTER (NM_SETTING_SECRET_FLAG_NONE));
+	priv->system_secrets = secrets_cache_new (nm_settings_connection_get_connection (self),
+	                                          NM_SETTING_SECRET_FLAG_NONE);
 }
 
 static void
 update_agent_secrets_cache (NMSettingsConnection *self, NMConnection *new)
 {
 	NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE (self);
-	NMSettingSecretFlags filter_flags = NM_SETTING_SECRET_FLAG_NOT_SAVED | NM_SETTING_SECRET_FLAG_AGENT_OWNED;
 
-	if (priv->agent_secrets)
-		g_object_unref (priv->agent_secrets);
-	priv->agent_secrets = nm_simple_connection_new_clone (   new
-	                                                      ?: nm_settings_connection_get_connection (self));
+	g_clear_pointer (&priv->agent_secrets, g_variant_unref);
 
 	/* Clear out non-system-owned secrets */
-	nm_connection_clear_secrets_with_flags (priv->agent_secrets,
-	                                        secrets_filter_cb,
-	                                        GUINT_TO_POINTER (filter_flags));
+	priv->agent_secrets = secrets_cache_new (new ?: nm_settings_connection_get_connection (self),
+	                                         NM_SETTING_SECRET_FLAG_NOT_SAVED | NM_SETTING_SECRET_FLAG_AGENT_OWNED);
 }
 
 static void
@@ -508,9 +541,7 @@ secrets_cleared_cb (NMConnection *connection, NMSettingsConnection *self)
 	/* Clear agent secrets when connection's secrets are cleared since agent
 	 * secrets are transient.
 	 */
-	if (priv->agent_secrets)
-		g_object_unref (priv->agent_secrets);
-	priv->agent_secrets = NULL;
+	g_clear_pointer (&priv->agent_secrets, g_variant_unref);
 }
 
 static void
@@ -551,9 +582,16 @@ set_persist_mode (NMSettingsConnection *self, NMSettingsConnectionPersistMode pe
 	nm_settings_connection_set_flags_full (self, ALL, flags);
 }
 
+static void
+_getsettings_cached_clear (NMSettingsConnection *self)
+{
+	g_clear_pointer (&NM_SETTINGS_CONNECTION_GET_PRIVATE (self)->getsettings_cached, g_variant_unref);
+}
+
 static void
 _emit_updated (NMSettingsConnection *self, gboolean by_user)
 {
+	_getsettings_cached_clear (self);
 	nm_dbus_object_emit_signal (NM_DBUS_OBJECT (self),
 	                            &interface_info_settings_connection,
 	                            &signal_info_updated,
@@ -664,6 +702,8 @@ nm_settings_connection_update (NMSettingsConnection *self,
 		goto out;
 
 	if (persist_mode == NM_SETTINGS_CONNECTION_PERSIST_MODE_DISK) {
+		nm_latency_measure_scope (NM_LATENCY_POINT_SETTINGS_WRITE);
+
 		if (!klass->commit_changes (self,
 		                            new_connection ?: nm_settings_connection_get_connection (self),
 		                            commit_reason,
@@ -725,15 +765,8 @@ nm_settings_connection_update (NMSettingsConnection *self,
 		/* Add agent and always-ask secrets back; they won't necessarily be
 		 * in the replacement connection data if it was eg reread from disk.
 		 */
-		if (priv->agent_secrets) {
-			GVariant *dict;
-
-			dict = nm_connection_to_dbus (priv->agent_secrets, NM_CONNECTION_SERIALIZE_ONLY_SECRETS);
-			if (dict) {
-				(void) nm_connection_update_secrets (nm_settings_connection_get_connection (self), NULL, dict, NULL);
-				g_variant_unref (dict);
-			}
-		}
+		if (priv->agent_secrets)
+			(void) nm_connection_update_secrets (nm_settings_connection_get_connection (self), NULL, priv->agent_secrets, NULL);
 		if (con_agent_secrets)
 			(void) nm_connection_update_secrets (nm_settings_connection_get_connection (self), NULL, con_agent_secrets, NULL);
 	}
@@ -1126,7 +1159,7 @@ get_secrets_done_cb (NMAgentManager *manager,
 	       call_id);
 
 	if (priv->system_secrets)
-		dict = nm_connection_to_dbus (priv->system_secrets, NM_CONNECTION_SERIALIZE_ONLY_SECRETS);
+		dict = g_variant_ref (priv->system_secrets);
 
 	/* Update the connection with our existing secrets from backing storage */
 	nm_connection_clear_secrets (nm_settings_connection_get_connection (self));
@@ -1311,9 +1344,7 @@ nm_settings_connection_get_secrets (NMSettingsConnection *self,
 	 * will clear secrets on this object's settings.
 	 */
 	if (priv->system_secrets)
-		existing_secrets = nm_connection_to_dbus (priv->system_secrets, NM_CONNECTION_SERIALIZE_ONLY_SECRETS);
-	if (existing_secrets)
-		g_variant_ref_sink (existing_secrets);
+		existing_secrets = g_variant_ref (priv->system_secrets);
 
 	/* we remember the current version-id of the secret-agents. The version-id is strictly increasing,
 	 * as new agents register the number. We know hence, that this request was made against a certain
@@ -1565,9 +1596,14 @@ get_settings_auth_cb (NMSettingsConnection *self,
                       GError *error,
                       gpointer data)
 {
+	NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE (self);
+
 	if (error)
 		g_dbus_method_invocation_return_gerror (context, error);
-	else {
+	else if (priv->getsettings_cached) {
+		g_dbus_method_invocation_return_value (context,
+		                                       g_variant_new ("(@a{sa{sv}})", priv->getsettings_cached));
+	} else {
 		gs_unref_object NMConnection *dupl_con = NULL;
 		GVariant *settings;
 		NMSettingConnection *s_con;
@@ -1602,6 +1638,7 @@ get_settings_auth_cb (NMSettingsConnection *self,
 		 * protected against leakage of secrets to unprivileged callers.
 		 */
 		settings = nm_connection_to_dbus (dupl_con, NM_CONNECTION_SERIALIZE_NO_SECRETS);
+		priv->getsettings_cached = g_variant_ref_sink (settings);
 		g_dbus_method_invocation_return_value (context,
 		                                       g_variant_new ("(@a{sa{sv}})", settings));
 	}
@@ -1675,22 +1712,11 @@ static void
 cached_secrets_to_connection (NMSettingsConnection *self, NMConnection *connection)
 {
 	NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE (self);
-	GVariant *secrets_dict;
 
-	if (priv->agent_secrets) {
-		secrets_dict = nm_connection_to_dbus (priv->agent_secrets, NM_CONNECTION_SERIALIZE_ONLY_SECRETS);
-		if (secrets_dict) {
-			(void) nm_connection_update_secrets (connection, NULL, secrets_dict, NULL);
-			g_variant_unref (secrets_dict);
-		}
-	}
-	if (priv->system_secrets) {
-		secrets_dict = nm_connection_to_dbus (priv->system_secrets, NM_CONNECTION_SERIALIZE_ONLY_SECRETS);
-		if (secrets_dict) {
-			(void) nm_connection_update_secrets (connection, NULL, secrets_dict, NULL);
-			g_variant_unref (secrets_dict);
-		}
-	}
+	if (priv->agent_secrets)
+		(void) nm_connection_update_secrets (connection, NULL, priv->agent_secrets, NULL);
+	if (priv->system_secrets)
+		(void) nm_connection_update_secrets (connection, NULL, priv->system_secrets, NULL);
 }
 
 static void
@@ -2226,10 +2252,18 @@ dbus_clear_secrets_auth_cb (NMSettingsConnection *self,
 
 	/* Clear secrets in connection and caches */
 	nm_connection_clear_secrets (nm_settings_connection_get_connection (self));
-	if (priv->system_secrets)
-		nm_connection_clear_secrets (priv->system_secrets);
-	if (priv->agent_secrets)
-		nm_connection_clear_secrets (priv->agent_secrets);
+	if (priv->system_secrets) {
+		GVariant *dict = priv->system_secrets;
+
+		priv->system_secrets = secrets_cache_clear (dict);
+		g_variant_unref (dict);
+	}
+	if (priv->agent_secrets) {
+		GVariant *dict = priv->agent_secrets;
+
+		priv->agent_secrets = secrets_cache_clear (dict);
+		g_variant_unref (dict);
+	}
 
 	/* Tell agents to remove secrets for this connection */
 	nm_agent_manager_delete_secrets (priv->agent_mgr,
@@ -2505,6 +2539,8 @@ nm_settings_connection_update_timestamp (NMSettingsConnection *self,
 	g_return_if_fail (NM_IS_SETTINGS_CONNECTION (self));
 
 	/* Update timestamp in private storage */
+	if (priv->timestamp != timestamp)
+		_getsettings_cached_clear (self);
 	priv->timestamp = timestamp;
 	priv->timestamp_set = TRUE;
 
@@ -2576,6 +2612,7 @@ nm_settings_connection_read_and_fill_timestamp (NMSettingsConnection *self)
 		return;
 	}
 
+	_getsettings_cached_clear (self);
 	priv->timestamp = timestamp;
 	priv->timestamp_set = TRUE;
 }
@@ -2657,6 +2694,7 @@ nm_settings_connection_add_seen_bssid (NMSettingsConnection *self,
 	/* Add the new BSSID; let the hash take ownership of the allocated BSSID string */
 	bssid_str = g_strdup (seen_bssid);
 	g_hash_table_insert (priv->seen_bssids, bssid_str, bssid_str);
+	_getsettings_cached_clear (self);
 
 	/* Build up a list of all the BSSIDs in string form */
 	n = 0;
@@ -2720,6 +2758,8 @@ nm_settings_connection_read_and_fill_seen_bssids (NMSettingsConnection *self)
 	}
 	g_key_file_free (seen_bssids_file);
 
+	_getsettings_cached_clear (self);
+
 	/* Update connection's seen-bssids */
 	if (tmp_strv) {
 		g_hash_table_remove_all (priv->seen_bssids);
@@ -2989,6 +3029,8 @@ nm_settings_connection_init (NMSettingsConnection *self)
 	priv = G_TYPE_INSTANCE_GET_PRIVATE (self, NM_TYPE_SETTINGS_CONNECTION, NMSettingsConnectionPrivate);
 	self->_priv = priv;
 
+	nm_utils_alive_counter_inc (NM_UTILS_ALIVE_COUNTER_SETTINGS_CONNECTION);
+
 	c_list_init (&self->_connections_lst);
 
 	priv->ready = TRUE;
@@ -3054,10 +3096,11 @@ dispose (GObject *object)
 		nm_connection_clear_secrets (priv->connection);
 	}
 
-	g_clear_object (&priv->system_secrets);
-	g_clear_object (&priv->agent_secrets);
+	g_clear_pointer (&priv->system_secrets, g_variant_unref);
+	g_clear_pointer (&priv->agent_secrets, g_variant_unref);
 
 	g_clear_pointer (&priv->seen_bssids, g_hash_table_destroy);
+	g_clear_pointer (&priv->getsettings_cached, g_variant_unref);
 
 	nm_clear_g_signal_handler (priv->session_monitor, &priv->session_changed_id);
 	g_clear_object (&priv->session_monitor);
@@ -3071,6 +3114,14 @@ dispose (GObject *object)
 	G_OBJECT_CLASS (nm_settings_connection_parent_class)->dispose (object);
 }
 
+static void
+finalize (GObject *object)
+{
+	nm_utils_alive_counter_dec (NM_UTILS_ALIVE_COUNTER_SETTINGS_CONNECTION);
+
+	G_OBJECT_CLASS (nm_settings_connection_parent_class)->finalize (object);
+}
+
 static void
 get_property (GObject *object, guint prop_id,
               GValue *value, GParamSpec *pspec)
@@ -3225,6 +3276,7 @@ nm_settings_connection_class_init (NMSettingsConnectionClass *klass)
 
 	object_class->constructed = constructed;
 	object_class->dispose = dispose;
+	object_class->finalize = finalize;
 	object_class->get_property = get_property;
 	object_class->set_property = set_property;
 
@@ -72,6 +72,7 @@
 #include "nm-auth-subject.h"
 #include "nm-session-monitor.h"
 #include "plugins/keyfile/nms-keyfile-plugin.h"
+#include "plugins/keyfile/nms-keyfile-writer.h"
 #include "nm-agent-manager.h"
 #include "nm-config.h"
 #include "nm-audit-manager.h"
@@ -1083,7 +1084,12 @@ nm_settings_add_connection (NMSettings *self,
 		                                        GUINT_TO_POINTER (NM_SETTING_SECRET_FLAG_AGENT_OWNED));
 		secrets = nm_connection_to_dbus (simple, NM_CONNECTION_SERIALIZE_ONLY_SECRETS);
 
-		added = nm_settings_plugin_add_connection (plugin, connection, save_to_disk, &add_error);
+		if (save_to_disk) {
+			nm_latency_measure_scope (NM_LATENCY_POINT_SETTINGS_WRITE);
+
+			added = nm_settings_plugin_add_connection (plugin, connection, TRUE, &add_error);
+		} else
+			added = nm_settings_plugin_add_connection (plugin, connection, FALSE, &add_error);
 		if (added) {
 			if (secrets) {
 				/* FIXME(copy-on-write-connection): avoid modifying NMConnection instances and share them via copy-on-write. */
@@ -1219,33 +1225,25 @@ is_adhoc_wpa (NMConnection *connection)
 	return TRUE;
 }
 
-void
-nm_settings_add_connection_dbus (NMSettings *self,
-                                 NMConnection *connection,
-                                 gboolean save_to_disk,
-                                 NMAuthSubject *subject,
-                                 GDBusMethodInvocation *context,
-                                 NMSettingsAddCallback callback,
-                                 gpointer user_data)
+/* Checks whether @connection may be added by @subject and returns the
+ * permission that needs to be authorized for that. */
+static const char *
+add_connection_check (NMConnection *connection,
+                      NMAuthSubject *subject,
+                      GError **error)
 {
-	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
 	NMSettingConnection *s_con;
-	NMAuthChain *chain;
-	GError *error = NULL, *tmp_error = NULL;
-	const char *perm;
-
-	g_return_if_fail (NM_IS_CONNECTION (connection));
-	g_return_if_fail (NM_IS_AUTH_SUBJECT (subject));
-	g_return_if_fail (G_IS_DBUS_METHOD_INVOCATION (context));
+	GError *tmp_error = NULL;
 
 	/* Connection must be valid, of course */
 	if (!nm_connection_verify (connection, &tmp_error)) {
-		error = g_error_new (NM_SETTINGS_ERROR,
-		                     NM_SETTINGS_ERROR_INVALID_CONNECTION,
-		                     "The connection was invalid: %s",
-		                     tmp_error->message);
+		g_set_error (error,
+		             NM_SETTINGS_ERROR,
+		             NM_SETTINGS_ERROR_INVALID_CONNECTION,
+		             "The connection was invalid: %s",
+		             tmp_error->message);
 		g_error_free (tmp_error);
-		goto done;
+		return NULL;
 	}
 
 	/* The kernel doesn't support Ad-Hoc WPA connections well at this time,
@@ -1253,18 +1251,19 @@ nm_settings_add_connection_dbus (NMSettings *self,
 	 * 2.6.30 or so; until that's fixed, disable WPA-protected Ad-Hoc networks.
 	 */
 	if (is_adhoc_wpa (connection)) {
-		error = g_error_new_literal (NM_SETTINGS_ERROR,
-		                             NM_SETTINGS_ERROR_INVALID_CONNECTION,
-		                             "WPA Ad-Hoc disabled due to kernel bugs");
-		goto done;
+		g_set_error_literal (error,
+		                     NM_SETTINGS_ERROR,
+		                     NM_SETTINGS_ERROR_INVALID_CONNECTION,
+		                     "WPA Ad-Hoc disabled due to kernel bugs");
+		return NULL;
 	}
 
 	if (!nm_auth_is_subject_in_acl_set_error (connection,
 	                                          subject,
 	                                          NM_SETTINGS_ERROR,
 	                                          NM_SETTINGS_ERROR_PERMISSION_DENIED,
-	                                          &error))
-		goto done;
+	                                          error))
+		return NULL;
 
 	/* If the caller is the only user in the connection's permissions, then
 	 * we use the 'modify.own' permission instead of 'modify.system'.  If the
@@ -1273,9 +1272,31 @@ nm_settings_add_connection_dbus (NMSettings *self,
 	s_con = nm_connection_get_setting_connection (connection);
 	g_assert (s_con);
 	if (nm_setting_connection_get_num_permissions (s_con) == 1)
-		perm = NM_AUTH_PERMISSION_SETTINGS_MODIFY_OWN;
-	else
-		perm = NM_AUTH_PERMISSION_SETTINGS_MODIFY_SYSTEM;
+		return NM_AUTH_PERMISSION_SETTINGS_MODIFY_OWN;
+	return NM_AUTH_PERMISSION_SETTINGS_MODIFY_SYSTEM;
+}
+
+void
+nm_settings_add_connection_dbus (NMSettings *self,
+                                 NMConnection *connection,
+                                 gboolean save_to_disk,
+                                 NMAuthSubject *subject,
+                                 GDBusMethodInvocation *context,
+                                 NMSettingsAddCallback callback,
+                                 gpointer user_data)
+{
+	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
+	NMAuthChain *chain;
+	GError *error = NULL;
+	const char *perm;
+
+	g_return_if_fail (NM_IS_CONNECTION (connection));
+	g_return_if_fail (NM_IS_AUTH_SUBJECT (subject));
+	g_return_if_fail (G_IS_DBUS_METHOD_INVOCATION (context));
+
+	perm = add_connection_check (connection, subject, &error);
+	if (!perm)
+		goto done;
 
 	/* Validate the user request */
 	chain = nm_auth_chain_new_subject (subject, context, pk_add_cb, self);
@@ -1393,6 +1414,227 @@ impl_settings_add_connection_unsaved (NMDBusObject *obj,
 	settings_add_connection_helper (self, invocation, settings, FALSE);
 }
 
+typedef struct {
+	NMConnection *connection;
+	const char *perm;
+	NMSettingsConnection *added;
+	GError *error;
+} AddConnectionsItem;
+
+static void
+add_connections_item_clear (gpointer data)
+{
+	AddConnectionsItem *item = data;
+
+	g_clear_object (&item->connection);
+	g_clear_object (&item->added);
+	g_clear_error (&item->error);
+}
+
+static void
+add_connections_return (GDBusMethodInvocation *context,
+                        NMAuthSubject *subject,
+                        GArray *items)
+{
+	GVariantBuilder paths;
+	GVariantBuilder errors;
+	guint i;
+
+	g_variant_builder_init (&paths, G_VARIANT_TYPE ("ao"));
+	g_variant_builder_init (&errors, G_VARIANT_TYPE ("as"));
+
+	for (i = 0; i < items->len; i++) {
+		AddConnectionsItem *item = &g_array_index (items, AddConnectionsItem, i);
+
+		if (item->added) {
+			g_variant_builder_add (&paths, "o", nm_dbus_object_get_path (NM_DBUS_OBJECT (item->added)));
+			g_variant_builder_add (&errors, "s", "");
+			nm_audit_log_connection_op (NM_AUDIT_OP_CONN_ADD, item->added, TRUE, NULL,
+			                            subject, NULL);
+		} else {
+			nm_assert (item->error);
+			g_variant_builder_add (&paths, "o", "/");
+			g_variant_builder_add (&errors, "s", item->error->message);
+			nm_audit_log_connection_op (NM_AUDIT_OP_CONN_ADD, NULL, FALSE, NULL,
+			                            subject, item->error->message);
+		}
+	}
+
+	g_dbus_method_invocation_return_value (context,
+	                                       g_variant_new ("(aoas)", &paths, &errors));
+}
+
+static void
+pk_add_connections_cb (NMAuthChain *chain,
+                       GError *chain_error,
+                       GDBusMethodInvocation *context,
+                       gpointer user_data)
+{
+	NMSettings *self = NM_SETTINGS (user_data);
+	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
+	NMAuthSubject *subject;
+	gs_unref_hashtable GHashTable *failed_paths = NULL;
+	GArray *items;
+	guint i;
+
+	g_assert (context);
+
+	priv->auths = g_slist_remove (priv->auths, chain);
+
+	items = nm_auth_chain_get_data (chain, "items");
+	subject = nm_auth_chain_get_data (chain, "subject");
+
+	/* Sync all written keyfiles at once instead of one fsync() per
+	 * connection. The batch ends before replying, so that the caller
+	 * only gets the result once the connections are on disk. */
+	nms_keyfile_writer_batch_begin ();
+
+	for (i = 0; i < items->len; i++) {
+		AddConnectionsItem *item = &g_array_index (items, AddConnectionsItem, i);
+		NMSettingsConnection *added;
+
+		if (item->error)
+			continue;
+
+		if (chain_error) {
+			item->error = g_error_new (NM_SETTINGS_ERROR,
+			                           NM_SETTINGS_ERROR_FAILED,
+			                           "Error checking authorization: %s",
+			                           chain_error->message);
+		} else if (nm_auth_chain_get_result (chain, item->perm) != NM_AUTH_CALL_RESULT_YES) {
+			item->error = g_error_new_literal (NM_SETTINGS_ERROR,
+			                                   NM_SETTINGS_ERROR_PERMISSION_DENIED,
+			                                   "Insufficient privileges.");
+		} else {
+			added = nm_settings_add_connection (self, item->connection, TRUE, &item->error);
+			if (added)
+				item->added = g_object_ref (added);
+		}
+	}
+
+	failed_paths = nms_keyfile_writer_batch_end ();
+	if (failed_paths) {
+		/* the profiles whose file could not be saved must not stay around
+		 * as if they were added. */
+		for (i = 0; i < items->len; i++) {
+			AddConnectionsItem *item = &g_array_index (items, AddConnectionsItem, i);
+			const char *filename;
+			const char *msg;
+
+			if (!item->added)
+				continue;
+
+			filename = nm_settings_connection_get_filename (item->added);
+			if (   !filename
+			    || !(msg = g_hash_table_lookup (failed_paths, filename)))
+				continue;
+
+			item->error = g_error_new_literal (NM_SETTINGS_ERROR,
+			                                   NM_SETTINGS_ERROR_FAILED,
+			                                   msg);
+			if (nm_settings_has_connection (self, item->added))
+				nm_settings_connection_delete (item->added, NULL);
+			g_clear_object (&item->added);
+		}
+	}
+
+	add_connections_return (context, subject, items);
+
+	/* Send agent-owned secrets to the agents */
+	for (i = 0; i < items->len; i++) {
+		AddConnectionsItem *item = &g_array_index (items, AddConnectionsItem, i);
+
+		if (   item->added
+		    && nm_settings_has_connection (self, item->added))
+			send_agent_owned_secrets (self, item->added, subject);
+	}
+
+	nm_auth_chain_destroy (chain);
+}
+
+static void
+impl_settings_add_connections (NMDBusObject *obj,
+                               const NMDBusInterfaceInfoExtended *interface_info,
+                               const NMDBusMethodInfoExtended *method_info,
+                               GDBusConnection *dbus_connection,
+                               const char *sender,
+                               GDBusMethodInvocation *invocation,
+                               GVariant *parameters)
+{
+	NMSettings *self = NM_SETTINGS (obj);
+	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
+	gs_unref_variant GVariant *settings_array = NULL;
+	gs_unref_object NMAuthSubject *subject = NULL;
+	gs_unref_array GArray *items = NULL;
+	gboolean need_own = FALSE;
+	gboolean need_system = FALSE;
+	NMAuthChain *chain;
+	gsize i, n;
+
+	g_variant_get (parameters, "(@aa{sa{sv}})", &settings_array);
+
+	subject = nm_auth_subject_new_unix_process_from_context (invocation);
+	if (!subject) {
+		g_dbus_method_invocation_return_error_literal (invocation,
+		                                               NM_SETTINGS_ERROR,
+		                                               NM_SETTINGS_ERROR_PERMISSION_DENIED,
+		                                               "Unable to determine UID of request.");
+		return;
+	}
+
+	n = g_variant_n_children (settings_array);
+	items = g_array_sized_new (FALSE, TRUE, sizeof (AddConnectionsItem), n);
+	g_array_set_clear_func (items, add_connections_item_clear);
+	g_array_set_size (items, n);
+
+	/* Parse and check all connections upfront. Invalid ones only fail
+	 * their own item, the others are still added. */
+	for (i = 0; i < n; i++) {
+		AddConnectionsItem *item = &g_array_index (items, AddConnectionsItem, i);
+		gs_unref_variant GVariant *settings = NULL;
+
+		settings = g_variant_get_child_value (settings_array, i);
+		item->connection = _nm_simple_connection_new_from_dbus (settings,
+		                                                          NM_SETTING_PARSE_FLAGS_STRICT
+		                                                        | NM_SETTING_PARSE_FLAGS_NORMALIZE,
+		                                                        &item->error);
+		if (   !item->connection
+		    || !nm_connection_verify_secrets (item->connection, &item->error))
+			continue;
+
+		item->perm = add_connection_check (item->connection, subject, &item->error);
+		if (nm_streq0 (item->perm, NM_AUTH_PERMISSION_SETTINGS_MODIFY_OWN))
+			need_own = TRUE;
+		else if (item->perm)
+			need_system = TRUE;
+	}
+
+	if (!need_own && !need_system) {
+		/* nothing left to authorize */
+		add_connections_return (invocation, subject, items);
+		return;
+	}
+
+	/* Authorize each needed permission once for the whole request,
+	 * instead of once per connection. */
+	chain = nm_auth_chain_new_subject (subject, invocation, pk_add_connections_cb, self);
+	if (!chain) {
+		g_dbus_method_invocation_return_error_literal (invocation,
+		                                               NM_SETTINGS_ERROR,
+		                                               NM_SETTINGS_ERROR_PERMISSION_DENIED,
+		                                               "Unable to authenticate the request.");
+		return;
+	}
+
+	priv->auths = g_slist_append (priv->auths, chain);
+	nm_auth_chain_set_data (chain, "items", g_steal_pointer (&items), (GDestroyNotify) g_array_unref);
+	nm_auth_chain_set_data (chain, "subject", g_object_ref (subject), g_object_unref);
+	if (need_own)
+		nm_auth_chain_add_call (chain, NM_AUTH_PERMISSION_SETTINGS_MODIFY_OWN, TRUE);
+	if (need_system)
+		nm_auth_chain_add_call (chain, NM_AUTH_PERMISSION_SETTINGS_MODIFY_SYSTEM, TRUE);
+}
+
 static void
 impl_settings_load_connections (NMDBusObject *obj,
                                 const NMDBusInterfaceInfoExtended *interface_info,
@@ -1995,6 +2237,19 @@ static const NMDBusInterfaceInfoExtended interface_info_settings = {
 				),
 				.handle = impl_settings_add_connection_unsaved,
 			),
+			NM_DEFINE_DBUS_METHOD_INFO_EXTENDED (
+				NM_DEFINE_GDBUS_METHOD_INFO_INIT (
+					"AddConnections",
+					.in_args = NM_DEFINE_GDBUS_ARG_INFOS (
+						NM_DEFINE_GDBUS_ARG_INFO ("connections", "aa{sa{sv}}"),
+					),
+					.out_args = NM_DEFINE_GDBUS_ARG_INFOS (
+						NM_DEFINE_GDBUS_ARG_INFO ("paths", "ao"),
+						NM_DEFINE_GDBUS_ARG_INFO ("errors", "as"),
+					),
+				),
+				.handle = impl_settings_add_connections,
+			),
 			NM_DEFINE_DBUS_METHOD_INFO_EXTENDED (
 				NM_DEFINE_GDBUS_METHOD_INFO_INIT (
 					"LoadConnections",
@@ -50,6 +50,10 @@
 #define IFCFGRH1_IFACE1_NAME                            "com.redhat.ifcfgrh1"
 #define IFCFGRH1_IFACE1_METHOD_GET_IFCFG_DETAILS        "GetIfcfgDetails"
 
+/* file change events are collected for a short time, so that rewriting
+ * a profile (and its companion files) only results in one reload. */
+#define IFCFG_CHANGES_DELAY_MSEC                        200
+
 /*****************************************************************************/
 
 typedef struct {
@@ -67,6 +71,13 @@ typedef struct {
 
 	GFileMonitor *ifcfg_monitor;
 	gulong ifcfg_monitor_id;
+
+	/* the ifcfg paths with pending changes. */
+	GHashTable *pending_changes;
+	guint pending_changes_id;
+
+	/* how often a profile was parsed from disk. */
+	guint64 n_reparses;
 } SettingsPluginIfcfgPrivate;
 
 struct _SettingsPluginIfcfg {
@@ -109,6 +120,8 @@ static NMIfcfgConnection *update_connection (SettingsPluginIfcfg *plugin,
                                              GHashTable *protected_connections,
                                              GError **error);
 
+static void pending_changes_add (SettingsPluginIfcfg *self, const char *ifcfg_path);
+
 /*****************************************************************************/
 
 static void
@@ -128,7 +141,7 @@ connection_ifcfg_changed (NMIfcfgConnection *connection, gpointer user_data)
 
 	_LOGD ("connection_ifcfg_changed("NM_IFCFG_CONNECTION_LOG_FMTD"): %s", NM_IFCFG_CONNECTION_LOG_ARGD (connection), "reload");
 
-	update_connection (self, NULL, path, connection, TRUE, NULL, NULL);
+	pending_changes_add (self, path);
 }
 
 static void
@@ -207,6 +220,9 @@ update_connection (SettingsPluginIfcfg *self,
 	if (full_path)
 		_LOGD ("loading from file \"%s\"...", full_path);
 
+	if (!source)
+		priv->n_reparses++;
+
 	/* Create a NMIfcfgConnection instance, either by reading from @full_path or
 	 * based on @source. */
 	connection_new = nm_ifcfg_connection_new (source, full_path, &local, &ignore_error);
@@ -408,6 +424,67 @@ update_connection (SettingsPluginIfcfg *self,
 	}
 }
 
+static gboolean
+pending_changes_cb (gpointer user_data)
+{
+	SettingsPluginIfcfg *self = user_data;
+	SettingsPluginIfcfgPrivate *priv = SETTINGS_PLUGIN_IFCFG_GET_PRIVATE (self);
+	gs_unref_hashtable GHashTable *pending_changes = NULL;
+	gs_free const char **paths = NULL;
+	guint64 n_reparses;
+	guint i, n;
+
+	priv->pending_changes_id = 0;
+	pending_changes = g_steal_pointer (&priv->pending_changes);
+	if (!pending_changes)
+		return G_SOURCE_REMOVE;
+
+	n_reparses = priv->n_reparses;
+
+	/* sort the paths, for reproducible behavior. */
+	paths = (const char **) g_hash_table_get_keys_as_array (pending_changes, &n);
+	g_qsort_with_data (paths, n, sizeof (const char *), nm_strcmp_p_with_data, NULL);
+
+	for (i = 0; i < n; i++) {
+		NMIfcfgConnection *connection;
+
+		connection = find_by_path (self, paths[i]);
+		if (g_file_test (paths[i], G_FILE_TEST_EXISTS)) {
+			/* Update or new */
+			update_connection (self, NULL, paths[i], connection, TRUE, NULL, NULL);
+		} else if (connection)
+			remove_connection (self, connection);
+	}
+
+	_LOGD ("handled changes for %u files (%"G_GUINT64_FORMAT" reparsed, %"G_GUINT64_FORMAT" reparses in total)",
+	       n, priv->n_reparses - n_reparses, priv->n_reparses);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+pending_changes_add (SettingsPluginIfcfg *self, const char *ifcfg_path)
+{
+	SettingsPluginIfcfgPrivate *priv = SETTINGS_PLUGIN_IFCFG_GET_PRIVATE (self);
+
+	if (!priv->pending_changes)
+		priv->pending_changes = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, NULL);
+	g_hash_table_add (priv->pending_changes, g_strdup (ifcfg_path));
+
+	/* don't restart the timeout on every event, so that a steady stream of
+	 * events does not delay the reload indefinitely. */
+	if (!priv->pending_changes_id)
+		priv->pending_changes_id = g_timeout_add (IFCFG_CHANGES_DELAY_MSEC, pending_changes_cb, self);
+}
+
+static void
+pending_changes_clear (SettingsPluginIfcfg *self)
+{
+	SettingsPluginIfcfgPrivate *priv = SETTINGS_PLUGIN_IFCFG_GET_PRIVATE (self);
+
+	nm_clear_g_source (&priv->pending_changes_id);
+	g_clear_pointer (&priv->pending_changes, g_hash_table_unref);
+}
+
 static void
 ifcfg_dir_changed (GFileMonitor *monitor,
                    GFile *file,
@@ -417,23 +494,19 @@ ifcfg_dir_changed (GFileMonitor *monitor,
 {
 	SettingsPluginIfcfg *plugin = SETTINGS_PLUGIN_IFCFG (user_data);
 	char *path, *ifcfg_path;
-	NMIfcfgConnection *connection;
 
 	path = g_file_get_path (file);
 
 	ifcfg_path = utils_detect_ifcfg_path (path, FALSE);
 	_LOGD ("ifcfg_dir_changed(%s) = %d // %s", path, event_type, ifcfg_path ?: "(none)");
 	if (ifcfg_path) {
-		connection = find_by_path (plugin, ifcfg_path);
 		switch (event_type) {
 		case G_FILE_MONITOR_EVENT_DELETED:
-			if (connection)
-				remove_connection (plugin, connection);
-			break;
 		case G_FILE_MONITOR_EVENT_CREATED:
 		case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
-			/* Update or new */
-			update_connection (plugin, NULL, ifcfg_path, connection, TRUE, NULL, NULL);
+			/* the event may be for a companion file (keys-, route-, ...).
+			 * In any case, the owning ifcfg file gets reloaded. */
+			pending_changes_add (plugin, ifcfg_path);
 			break;
 		default:
 			break;
@@ -512,6 +585,10 @@ read_connections (SettingsPluginIfcfg *plugin)
 	guint i;
 	GPtrArray *filenames;
 	GHashTable *paths;
+	guint64 n_reparses = priv->n_reparses;
+
+	/* we are about to re-read all files. Pending changes are covered by that. */
+	pending_changes_clear (plugin);
 
 	dir = g_dir_open (IFCFG_DIR, 0, &err);
 	if (!dir) {
@@ -568,6 +645,9 @@ read_connections (SettingsPluginIfcfg *plugin)
 			remove_connection (plugin, dead_connections->pdata[i]);
 		g_ptr_array_free (dead_connections, TRUE);
 	}
+
+	_LOGD ("read connections: %"G_GUINT64_FORMAT" files parsed (%"G_GUINT64_FORMAT" reparses in total)",
+	       priv->n_reparses - n_reparses, priv->n_reparses);
 }
 
 static GSList *
@@ -1041,6 +1121,8 @@ dispose (GObject *object)
 
 	_dbus_clear (self);
 
+	pending_changes_clear (self);
+
 	if (priv->connections) {
 		g_hash_table_destroy (priv->connections);
 		priv->connections = NULL;
@@ -75,6 +75,15 @@ struct _shvarFile {
 	char      *fileName;
 	int        fd;
 	CList      lst_head;
+
+	/* index of the lines by key. For each key, it points to the last
+	 * line in @lst_head with that key, which is the one that counts. */
+	GHashTable *lst_idx;
+
+	/* the number of lines with a key that are shadowed by a later
+	 * line with the same key (and thus not in @lst_idx). */
+	guint      n_shadowed;
+
 	gboolean   modified;
 };
 
@@ -634,6 +643,7 @@ svFile_new (const char *name)
 	s->fd = -1;
 	s->fileName = g_strdup (name);
 	c_list_init (&s->lst_head);
+	s->lst_idx = g_hash_table_new (nm_str_hash, g_str_equal);
 	return s;
 }
 
@@ -771,6 +781,26 @@ line_set (shvarLine *line, const char *value)
 	return TRUE;
 }
 
+static void
+line_link_tail (shvarFile *s, shvarLine *line)
+{
+	c_list_link_tail (&s->lst_head, &line->lst);
+
+	if (!line->key)
+		return;
+
+	/* the index key points into @line, so use replace() to
+	 * also update the key of an existing entry. */
+	if (!g_hash_table_replace (s->lst_idx, (gpointer) line->key, line))
+		s->n_shadowed++;
+}
+
+static shvarLine *
+line_lookup (shvarFile *s, const char *key)
+{
+	return g_hash_table_lookup (s->lst_idx, key);
+}
+
 static void
 line_free (shvarLine *line)
 {
@@ -839,9 +869,9 @@ svOpenFileInternal (const char *name, gboolean create, GError **error)
 	s = svFile_new (name);
 
 	for (p = arena; (q = strchr (p, '\n')) != NULL; p = q + 1)
-		c_list_link_tail (&s->lst_head, &line_new_parse (p, q - p)->lst);
+		line_link_tail (s, line_new_parse (p, q - p));
 	if (p[0])
-		c_list_link_tail (&s->lst_head, &line_new_parse (p, strlen (p))->lst);
+		line_link_tail (s, line_new_parse (p, strlen (p)));
 	g_free (arena);
 
 	/* closefd is set if we opened the file read-only, so go ahead and
@@ -976,20 +1006,14 @@ svFindFirstKeyWithPrefix (shvarFile *s, const char *key_prefix)
 static const char *
 _svGetValue (shvarFile *s, const char *key, char **to_free)
 {
-	CList *current;
-	const shvarLine *line, *l;
+	const shvarLine *line;
 	const char *v;
 
 	nm_assert (s);
 	nm_assert (_shell_is_name (key, -1));
 	nm_assert (to_free);
 
-	line = NULL;
-	c_list_for_each (current, &s->lst_head) {
-		l = c_list_entry (current, shvarLine, lst);
-		if (l->key && nm_streq (l->key, key))
-			line = l;
-	}
+	line = line_lookup (s, key);
 
 	if (line && line->line) {
 		v = svUnescape (line->line, to_free);
@@ -1210,7 +1234,7 @@ svUnsetAll (shvarFile *s, SvKeyType match_key_type)
 gboolean
 svSetValue (shvarFile *s, const char *key, const char *value)
 {
-	CList *current;
+	CList *current, *safe;
 	shvarLine *line, *l;
 	gboolean changed = FALSE;
 
@@ -1219,17 +1243,21 @@ svSetValue (shvarFile *s, const char *key, const char *value)
 
 	nm_assert (_shell_is_name (key, -1));
 
-	line = NULL;
-	c_list_for_each (current, &s->lst_head) {
-		l = c_list_entry (current, shvarLine, lst);
-		if (l->key && nm_streq (l->key, key)) {
-			if (line) {
-				/* if we find multiple entries for the same key, we can
-				 * delete all but the last. */
-				line_free (line);
+	line = line_lookup (s, key);
+
+	if (   line
+	    && s->n_shadowed > 0) {
+		/* if we find multiple entries for the same key, we can
+		 * delete all but the last. */
+		c_list_for_each_safe (current, safe, &s->lst_head) {
+			l = c_list_entry (current, shvarLine, lst);
+			if (l == line)
+				break;
+			if (l->key && nm_streq (l->key, key)) {
+				line_free (l);
+				s->n_shadowed--;
 				changed = TRUE;
 			}
-			line = l;
 		}
 	}
 
@@ -1241,11 +1269,15 @@ svSetValue (shvarFile *s, const char *key, const char *value)
 		}
 	} else {
 		if (!line) {
-			c_list_link_tail (&s->lst_head, &line_new_build (key, value)->lst);
+			line_link_tail (s, line_new_build (key, value));
 			changed = TRUE;
 		} else {
+			/* line_set() may move the key within the line, which
+			 * is referenced by the index. */
+			g_hash_table_remove (s->lst_idx, key);
 			if (line_set (line, value))
 				changed = TRUE;
+			g_hash_table_insert (s->lst_idx, (gpointer) line->key, line);
 		}
 	}
 
@@ -1396,6 +1428,7 @@ svCloseFile (shvarFile *s)
 	if (s->fd >= 0)
 		nm_close (s->fd);
 	g_free (s->fileName);
+	g_hash_table_destroy (s->lst_idx);
 	c_list_for_each_safe (current, safe, &s->lst_head)
 		line_free (c_list_entry (current, shvarLine, lst));
 	g_slice_free (shvarFile, s);
@@ -9493,6 +9493,61 @@ test_svUnescape (void)
 
 /*****************************************************************************/
 
+static void
+test_sv_duplicate_keys (void)
+{
+	nmtst_auto_unlinkfile char *filename_tmp_1 = g_strdup (TEST_SCRATCH_DIR_TMP"/tmp-1");
+	shvarFile *sv;
+	gs_free_error GError *error = NULL;
+	gboolean success;
+	gs_free char *file_contents_out = NULL;
+
+	success = g_file_set_contents (filename_tmp_1,
+	                               "KEY1=a\n"
+	                               "  KEY2=b\n"
+	                               "KEY1=c\n"
+	                               "KEY2=d\n"
+	                               "KEY3='e f'\n"
+	                               "KEY1=g\n",
+	                               -1,
+	                               &error);
+	nmtst_assert_success (success, error);
+
+	sv = _svOpenFile (filename_tmp_1);
+
+	/* the last assignment wins */
+	_svGetValue_check (sv, "KEY1", "g");
+	_svGetValue_check (sv, "KEY2", "d");
+	_svGetValue_check (sv, "KEY3", "e f");
+	_svGetValue_check (sv, "KEY4", NULL);
+
+	/* setting a key drops the shadowed assignments */
+	g_assert (svSetValue (sv, "KEY1", "h"));
+	g_assert (!svSetValue (sv, "KEY1", "h"));
+	_svGetValue_check (sv, "KEY1", "h");
+
+	g_assert (svUnsetValue (sv, "KEY2"));
+	_svGetValue_check (sv, "KEY2", NULL);
+	g_assert (svSetValue (sv, "KEY2", "i"));
+	_svGetValue_check (sv, "KEY2", "i");
+
+	g_assert (svSetValue (sv, "KEY4", "j"));
+	_svGetValue_check (sv, "KEY4", "j");
+
+	success = svWriteFile (sv, 0644, &error);
+	nmtst_assert_success (success, error);
+	svCloseFile (sv);
+
+	file_contents_out = nmtst_file_get_contents (filename_tmp_1);
+	g_assert_cmpstr (file_contents_out, ==,
+	                 "KEY2=i\n"
+	                 "KEY3='e f'\n"
+	                 "KEY1=h\n"
+	                 "KEY4=j\n");
+}
+
+/*****************************************************************************/
+
 static void
 test_write_unknown (gconstpointer test_data)
 {
@@ -9989,6 +10044,7 @@ int main (int argc, char **argv)
 		g_error ("failure to create test directory \"%s\": %s", TEST_SCRATCH_DIR_TMP, g_strerror (errno));
 
 	g_test_add_func (TPATH "svUnescape", test_svUnescape);
+	g_test_add_func (TPATH "svDuplicateKeys", test_sv_duplicate_keys);
 
 	g_test_add_data_func (TPATH "write-unknown/1", TEST_IFCFG_DIR"/ifcfg-test-write-unknown-1", test_write_unknown);
 	g_test_add_data_func (TPATH "write-unknown/2", TEST_IFCFG_DIR"/ifcfg-test-write-unknown-2", test_write_unknown);
@@ -124,6 +124,9 @@ nms_keyfile_connection_init (NMSKeyfileConnection *connection)
 NMSKeyfileConnection *
 nms_keyfile_connection_new (NMConnection *source,
                             const char *full_path,
+                            NMSKeyfileReaderCache *reader_cache,
+                            struct stat *out_st,
+                            gboolean *out_templated,
                             GError **error)
 {
 	GObject *object;
@@ -137,7 +140,7 @@ nms_keyfile_connection_new (NMConnection *source,
 	if (source)
 		tmp = g_object_ref (source);
 	else {
-		tmp = nms_keyfile_reader_from_file (full_path, error);
+		tmp = nms_keyfile_reader_from_file_full (full_path, reader_cache, out_st, out_templated, error);
 		if (!tmp)
 			return NULL;
 
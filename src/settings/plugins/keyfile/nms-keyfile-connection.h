@@ -23,6 +23,7 @@
 #define __NMS_KEYFILE_CONNECTION_H__
 
 #include "settings/nm-settings-connection.h"
+#include "nms-keyfile-reader.h"
 
 #define NMS_TYPE_KEYFILE_CONNECTION            (nms_keyfile_connection_get_type ())
 #define NMS_KEYFILE_CONNECTION(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), NMS_TYPE_KEYFILE_CONNECTION, NMSKeyfileConnection))
@@ -38,6 +39,9 @@ GType nms_keyfile_connection_get_type (void);
 
 NMSKeyfileConnection *nms_keyfile_connection_new (NMConnection *source,
                                                   const char *filename,
+                                                  NMSKeyfileReaderCache *reader_cache,
+                                                  struct stat *out_st,
+                                                  gboolean *out_templated,
                                                   GError **error);
 
 #endif /* __NMS_KEYFILE_CONNECTION_H__ */
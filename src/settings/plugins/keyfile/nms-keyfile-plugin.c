@@ -40,14 +40,37 @@
 #include "settings/nm-settings-plugin.h"
 
 #include "nms-keyfile-connection.h"
+#include "nms-keyfile-reader.h"
 #include "nms-keyfile-writer.h"
 #include "nms-keyfile-utils.h"
 
+#define KEYFILE_READER_CACHE_FILE NMRUNDIR "/keyfile-cache"
+
 /*****************************************************************************/
 
+typedef struct {
+	char *path;
+	NMSKeyfileConnection *connection;
+
+	/* the identity of the file when we last read it. If the file still
+	 * has the same identity during a reload, it is not parsed again. */
+	dev_t st_dev;
+	ino_t st_ino;
+	off_t st_size;
+	struct timespec st_mtim;
+	bool st_valid:1;
+} FileEntry;
+
 typedef struct {
 	GHashTable *connections;  /* uuid::connection */
 
+	/* index of the connections that have a filename */
+	GHashTable *files;        /* path::FileEntry */
+	GHashTable *files_by_con; /* connection::FileEntry */
+
+	/* only set while reading all connections. */
+	NMSKeyfileReaderCache *reader_cache;
+
 	gboolean initialized;
 	GFileMonitor *monitor;
 	gulong monitor_id;
@@ -80,9 +103,117 @@ G_DEFINE_TYPE (NMSKeyfilePlugin, nms_keyfile_plugin, NM_TYPE_SETTINGS_PLUGIN)
 
 /*****************************************************************************/
 
+static void
+_file_entry_free (gpointer data)
+{
+	FileEntry *entry = data;
+
+	g_free (entry->path);
+	g_slice_free (FileEntry, entry);
+}
+
+static void
+_files_untrack (NMSKeyfilePlugin *self, NMSKeyfileConnection *connection)
+{
+	NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE (self);
+	FileEntry *entry;
+
+	entry = g_hash_table_lookup (priv->files_by_con, connection);
+	if (!entry)
+		return;
+
+	g_hash_table_remove (priv->files_by_con, connection);
+	g_hash_table_remove (priv->files, entry->path);
+}
+
+/* (re-)index @connection by its current filename. */
+static FileEntry *
+_files_track (NMSKeyfilePlugin *self, NMSKeyfileConnection *connection)
+{
+	NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE (self);
+	const char *path;
+	FileEntry *entry;
+
+	path = nm_settings_connection_get_filename (NM_SETTINGS_CONNECTION (connection));
+
+	entry = g_hash_table_lookup (priv->files_by_con, connection);
+	if (entry && nm_streq0 (entry->path, path))
+		return entry;
+
+	_files_untrack (self, connection);
+
+	if (!path)
+		return NULL;
+
+	entry = g_hash_table_lookup (priv->files, path);
+	if (entry) {
+		/* another connection claims the same file. The last one wins. */
+		g_hash_table_remove (priv->files_by_con, entry->connection);
+		entry->connection = connection;
+		entry->st_valid = FALSE;
+	} else {
+		entry = g_slice_new0 (FileEntry);
+		entry->path = g_strdup (path);
+		entry->connection = connection;
+		g_hash_table_insert (priv->files, entry->path, entry);
+	}
+	g_hash_table_insert (priv->files_by_con, connection, entry);
+	return entry;
+}
+
+static gboolean
+_file_entry_stat_equal (const FileEntry *entry, const struct stat *st)
+{
+	return    entry->st_valid
+	       && entry->st_dev == st->st_dev
+	       && entry->st_ino == st->st_ino
+	       && entry->st_size == st->st_size
+	       && entry->st_mtim.tv_sec == st->st_mtim.tv_sec
+	       && entry->st_mtim.tv_nsec == st->st_mtim.tv_nsec;
+}
+
+/* remember @st as the identity of @full_path, which was just read into (or
+ * written from) @connection. The stat must be taken before reading the file,
+ * so that a modification while reading is noticed on the next reload.
+ * Passing %NULL forgets the identity. */
+static void
+_files_update_stat (NMSKeyfilePlugin *self,
+                    NMSKeyfileConnection *connection,
+                    const char *full_path,
+                    const struct stat *st)
+{
+	FileEntry *entry;
+
+	entry = _files_track (self, connection);
+	if (!entry)
+		return;
+
+	if (   !st
+	    || !nm_streq (entry->path, full_path)) {
+		entry->st_valid = FALSE;
+		return;
+	}
+
+	entry->st_dev = st->st_dev;
+	entry->st_ino = st->st_ino;
+	entry->st_size = st->st_size;
+	entry->st_mtim = st->st_mtim;
+	entry->st_valid = TRUE;
+}
+
+static void
+connection_filename_changed_cb (NMSettingsConnection *sett_conn,
+                                GParamSpec *pspec,
+                                NMSKeyfilePlugin *self)
+{
+	_files_track (self, NMS_KEYFILE_CONNECTION (sett_conn));
+}
+
 static void
 connection_removed_cb (NMSettingsConnection *sett_conn, NMSKeyfilePlugin *self)
 {
+	g_signal_handlers_disconnect_by_func (sett_conn, connection_filename_changed_cb, self);
+	_files_untrack (self, NMS_KEYFILE_CONNECTION (sett_conn));
 	g_hash_table_remove (NMS_KEYFILE_PLUGIN_GET_PRIVATE (self)->connections,
 	                     nm_settings_connection_get_uuid (sett_conn));
 }
@@ -101,6 +232,8 @@ remove_connection (NMSKeyfilePlugin *self, NMSKeyfileConnection *connection)
 	/* Removing from the hash table should drop the last reference */
 	g_object_ref (connection);
 	g_signal_handlers_disconnect_by_func (connection, connection_removed_cb, self);
+	g_signal_handlers_disconnect_by_func (connection, connection_filename_changed_cb, self);
+	_files_untrack (self, connection);
 	removed = g_hash_table_remove (NMS_KEYFILE_PLUGIN_GET_PRIVATE (self)->connections,
 	                               nm_settings_connection_get_uuid (NM_SETTINGS_CONNECTION (connection)));
 	nm_settings_connection_signal_remove (NM_SETTINGS_CONNECTION (connection));
@@ -112,18 +245,12 @@ remove_connection (NMSKeyfilePlugin *self, NMSKeyfileConnection *connection)
 static NMSKeyfileConnection *
 find_by_path (NMSKeyfilePlugin *self, const char *path)
 {
-	NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE (self);
-	GHashTableIter iter;
-	NMSettingsConnection *candidate = NULL;
+	FileEntry *entry;
 
 	g_return_val_if_fail (path != NULL, NULL);
 
-	g_hash_table_iter_init (&iter, priv->connections);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &candidate)) {
-		if (g_strcmp0 (path, nm_settings_connection_get_filename (candidate)) == 0)
-			return NMS_KEYFILE_CONNECTION (candidate);
-	}
-	return NULL;
+	entry = g_hash_table_lookup (NMS_KEYFILE_PLUGIN_GET_PRIVATE (self)->files, path);
+	return entry ? entry->connection : NULL;
 }
 
 /* update_connection:
@@ -171,6 +298,9 @@ update_connection (NMSKeyfilePlugin *self,
 	NMSKeyfileConnection *connection_by_uuid;
 	GError *local = NULL;
 	const char *uuid;
+	struct stat st;
+	gboolean st_valid;
+	gboolean templated = FALSE;
 	int dir_len;
 
 	g_return_val_if_fail (!source || NM_IS_CONNECTION (source), NULL);
@@ -195,7 +325,24 @@ update_connection (NMSKeyfilePlugin *self,
 		return FALSE;
 	}
 
-	connection_new = nms_keyfile_connection_new (source, full_path, &local);
+	/* a connection from @source was just written to @full_path by us,
+	 * otherwise the reader reports the stat it took before parsing. */
+	st_valid = source
+	           ? (stat (full_path, &st) == 0)
+	           : TRUE;
+
+	connection_new = nms_keyfile_connection_new (source,
+	                                             full_path,
+	                                             source ? NULL : priv->reader_cache,
+	                                             source ? NULL : &st,
+	                                             source ? NULL : &templated,
+	                                             &local);
+
+	/* the content of a profile based on a template also depends on the
+	 * template file. Don't remember the stat, so that such profiles are
+	 * always read again on reload. */
+	if (templated)
+		st_valid = FALSE;
 	if (!connection_new) {
 		/* Error; remove the connection */
 		if (source)
@@ -284,6 +431,7 @@ update_connection (NMSKeyfilePlugin *self,
 			g_assert_no_error (local);
 		}
 		nm_settings_connection_set_filename (NM_SETTINGS_CONNECTION (connection_by_uuid), full_path);
+		_files_update_stat (self, connection_by_uuid, full_path, st_valid ? &st : NULL);
 		g_object_unref (connection_new);
 		return connection_by_uuid;
 	} else {
@@ -296,6 +444,10 @@ update_connection (NMSKeyfilePlugin *self,
 		g_signal_connect (connection_new, NM_SETTINGS_CONNECTION_REMOVED,
 		                  G_CALLBACK (connection_removed_cb),
 		                  self);
+		g_signal_connect (connection_new, "notify::" NM_SETTINGS_CONNECTION_FILENAME,
+		                  G_CALLBACK (connection_filename_changed_cb),
+		                  self);
+		_files_update_stat (self, connection_new, full_path, st_valid ? &st : NULL);
 
 		if (!source) {
 			/* Only raise the signal if we were called without source, i.e. if we read the connection from file.
@@ -390,45 +542,37 @@ setup_monitoring (NMSettingsPlugin *config)
 	                  config);
 }
 
-static GHashTable *
-_paths_from_connections (GHashTable *connections)
-{
-	GHashTableIter iter;
-	NMSKeyfileConnection *connection;
-	GHashTable *paths = g_hash_table_new (nm_str_hash, g_str_equal);
-
-	g_hash_table_iter_init (&iter, connections);
-	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &connection)) {
-		const char *path = nm_settings_connection_get_filename (NM_SETTINGS_CONNECTION (connection));
+typedef struct {
+	char *path;
+	struct stat st;
+	bool st_valid:1;
+	bool known:1;
+} ReadDirFile;
 
-		if (path)
-			g_hash_table_add (paths, (void *) path);
-	}
-	return paths;
+static void
+_read_dir_file_clear (gpointer data)
+{
+	g_free (((ReadDirFile *) data)->path);
 }
 
 static int
-_sort_paths (const char **f1, const char **f2, GHashTable *paths)
+_sort_paths (const ReadDirFile *f1, const ReadDirFile *f2)
 {
-	struct stat st;
-	gboolean c1, c2;
 	gint64 m1, m2;
 
-	c1 = !!g_hash_table_contains (paths, *f1);
-	c2 = !!g_hash_table_contains (paths, *f2);
-	if (c1 != c2)
-		return c1 ? -1 : 1;
+	if (f1->known != f2->known)
+		return f1->known ? -1 : 1;
 
-	m1 = stat (*f1, &st) == 0 ? (gint64) st.st_mtime : G_MININT64;
-	m2 = stat (*f2, &st) == 0 ? (gint64) st.st_mtime : G_MININT64;
+	m1 = f1->st_valid ? (gint64) f1->st.st_mtime : G_MININT64;
+	m2 = f2->st_valid ? (gint64) f2->st.st_mtime : G_MININT64;
 	if (m1 != m2)
 		return m1 > m2 ? -1 : 1;
 
-	return strcmp (*f1, *f2);
+	return strcmp (f1->path, f2->path);
 }
 
 static void
-_read_dir (GPtrArray *filenames, const char *path)
+_read_dir (GArray *files, const char *path)
 {
 	GDir *dir;
 	const char *item;
@@ -442,9 +586,15 @@ _read_dir (GPtrArray *filenames, const char *path)
 	}
 
 	while ((item = g_dir_read_name (dir))) {
+		ReadDirFile *f;
+
 		if (nms_keyfile_utils_should_ignore_file (item))
 			continue;
-		g_ptr_array_add (filenames, g_build_filename (path, item, NULL));
+
+		g_array_set_size (files, files->len + 1);
+		f = &g_array_index (files, ReadDirFile, files->len - 1);
+		f->path = g_build_filename (path, item, NULL);
+		f->st_valid = (stat (f->path, &f->st) == 0);
 	}
 	g_dir_close (dir);
 }
@@ -460,32 +610,82 @@ read_connections (NMSettingsPlugin *config)
 	NMSKeyfileConnection *connection;
 	GPtrArray *dead_connections = NULL;
 	guint i;
-	GPtrArray *filenames;
-	GHashTable *paths;
+	GArray *files;
+	guint n_parsed = 0;
+	guint n_unchanged = 0;
 
-	filenames = g_ptr_array_new_with_free_func (g_free);
+	files = g_array_new (FALSE, FALSE, sizeof (ReadDirFile));
+	g_array_set_clear_func (files, _read_dir_file_clear);
 
-	_read_dir (filenames, NM_CONFIG_KEYFILE_PATH_IN_MEMORY);
-	_read_dir (filenames, nms_keyfile_utils_get_path ());
+	if (nm_config_data_get_value_boolean (nm_config_get_data (priv->config),
+	                                      NM_CONFIG_KEYFILE_GROUP_KEYFILE,
+	                                      NM_CONFIG_KEYFILE_KEY_KEYFILE_CACHE,
+	                                      FALSE))
+		priv->reader_cache = nms_keyfile_reader_cache_new (KEYFILE_READER_CACHE_FILE);
+
+	_read_dir (files, NM_CONFIG_KEYFILE_PATH_IN_MEMORY);
+	_read_dir (files, nms_keyfile_utils_get_path ());
 
 	alive_connections = g_hash_table_new (nm_direct_hash, NULL);
 
+	for (i = 0; i < files->len; i++) {
+		ReadDirFile *f = &g_array_index (files, ReadDirFile, i);
+
+		f->known = g_hash_table_contains (priv->files, f->path);
+	}
+
 	/* While reloading, we don't replace connections that we already loaded while
 	 * iterating over the files.
 	 *
 	 * To have sensible, reproducible behavior, sort the paths by last modification
 	 * time preferring older files.
 	 */
-	paths = _paths_from_connections (priv->connections);
-	g_ptr_array_sort_with_data (filenames, (GCompareDataFunc) _sort_paths, paths);
-	g_hash_table_destroy (paths);
+	g_array_sort (files, (GCompareFunc) _sort_paths);
+
+	for (i = 0; i < files->len; i++) {
+		ReadDirFile *f = &g_array_index (files, ReadDirFile, i);
+		FileEntry *entry;
+
+		/* loading a file can re-index other connections. Look up the
+		 * entry only now. */
+		entry = f->known ? g_hash_table_lookup (priv->files, f->path) : NULL;
+
+		/* Skip files that did not change since we read them last, unless the
+		 * connection was modified in memory (in which case reloading reverts it
+		 * to the content of the file). */
+		if (   entry
+		    && f->st_valid
+		    && _file_entry_stat_equal (entry, &f->st)
+		    && !nm_settings_connection_get_unsaved (NM_SETTINGS_CONNECTION (entry->connection))
+		    && !g_hash_table_contains (alive_connections, entry->connection)) {
+			g_hash_table_add (alive_connections, entry->connection);
+			/* the reader cache file only gets the entries of the files
+			 * passed to it. Keep the ones we don't read again. */
+			if (priv->reader_cache)
+				nms_keyfile_reader_cache_keep (priv->reader_cache, f->path, &f->st);
+			n_unchanged++;
+			continue;
+		}
 
-	for (i = 0; i < filenames->len; i++) {
-		connection = update_connection (self, NULL, filenames->pdata[i], NULL, FALSE, alive_connections, NULL);
+		n_parsed++;
+		connection = update_connection (self, NULL, f->path, NULL, FALSE, alive_connections, NULL);
 		if (connection)
 			g_hash_table_add (alive_connections, connection);
 	}
-	g_ptr_array_free (filenames, TRUE);
+	g_array_free (files, TRUE);
+
+	nms_keyfile_reader_templates_prune ();
+
+	if (priv->reader_cache) {
+		gs_free_error GError *error = NULL;
+		guint n_hits, n_misses;
+
+		nms_keyfile_reader_cache_get_stats (priv->reader_cache, &n_hits, &n_misses);
+		_LOGD ("reader cache: %u hits, %u misses", n_hits, n_misses);
+		if (!nms_keyfile_reader_cache_write (priv->reader_cache, &error))
+			_LOGW ("failure to write reader cache \"%s\": %s", KEYFILE_READER_CACHE_FILE, error->message);
+		g_clear_pointer (&priv->reader_cache, nms_keyfile_reader_cache_free);
+	}
 
 	g_hash_table_iter_init (&iter, priv->connections);
 	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &connection)) {
@@ -501,8 +701,13 @@ read_connections (NMSettingsPlugin *config)
 	if (dead_connections) {
 		for (i = 0; i < dead_connections->len; i++)
 			remove_connection (self, dead_connections->pdata[i]);
-		g_ptr_array_free (dead_connections, TRUE);
 	}
+
+	_LOGI ("read connections: %u files parsed, %u unchanged files skipped, %u connections removed",
+	       n_parsed, n_unchanged, dead_connections ? dead_connections->len : 0u);
+
+	if (dead_connections)
+		g_ptr_array_free (dead_connections, TRUE);
 }
 
 /*****************************************************************************/
@@ -586,6 +791,8 @@ nms_keyfile_plugin_init (NMSKeyfilePlugin *plugin)
 
 	priv->config = g_object_ref (nm_config_get ());
 	priv->connections = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, g_object_unref);
+	priv->files = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, _file_entry_free);
+	priv->files_by_con = g_hash_table_new (nm_direct_hash, NULL);
 }
 
 static void
@@ -621,10 +828,22 @@ dispose (GObject *object)
 	}
 
 	if (priv->connections) {
+		GHashTableIter iter;
+		NMSKeyfileConnection *connection;
+
+		g_hash_table_iter_init (&iter, priv->connections);
+		while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &connection))
+			g_signal_handlers_disconnect_by_data (connection, object);
+
 		g_hash_table_destroy (priv->connections);
 		priv->connections = NULL;
 	}
 
+	g_clear_pointer (&priv->files_by_con, g_hash_table_destroy);
+	g_clear_pointer (&priv->files, g_hash_table_destroy);
+
+	nms_keyfile_reader_templates_clear ();
+
 	if (priv->config) {
 		g_signal_handlers_disconnect_by_func (priv->config, config_changed_cb, object);
 		g_clear_object (&priv->config);
@@ -24,10 +24,14 @@
 
 #include <sys/stat.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "nm-keyfile-internal.h"
+#include "nm-core-internal.h"
+#include "nm-utils/nm-io-utils.h"
 
 #include "NetworkManagerUtils.h"
+#include "nms-keyfile-utils.h"
 
 /*****************************************************************************/
 
@@ -112,41 +116,528 @@ nms_keyfile_reader_from_keyfile (GKeyFile *key_file,
 	return nm_keyfile_read (key_file, filename, NULL, _handler_read, &data, error);
 }
 
+/*****************************************************************************/
+
+/* The reader cache stores connections that were already read and normalized,
+ * serialized as a GVariant in the D-Bus format. The cache file gets mapped
+ * into memory, and a cached connection is only used if the stat() information
+ * of the keyfile still matches exactly.
+ *
+ * The cache is only valid for the same version of NetworkManager (as reading
+ * and normalization might change between versions). */
+
+#define CACHE_VERSION            "keyfile-cache-1 " VERSION
+#define CACHE_ENTRY_TYPE         "(ttxxuuua{sa{sv}})"
+#define CACHE_FILE_TYPE          "(sa{s" CACHE_ENTRY_TYPE "})"
+
+struct _NMSKeyfileReaderCache {
+	char *filename;
+	GVariant *loaded;
+	GHashTable *entries_loaded; /* path::GVariant */
+	GHashTable *entries;        /* path::GVariant, the entries for the next cache file */
+	guint n_hits;
+	guint n_misses;
+	bool dirty:1;
+};
+
+NMSKeyfileReaderCache *
+nms_keyfile_reader_cache_new (const char *filename)
+{
+	NMSKeyfileReaderCache *cache;
+	gs_unref_bytes GBytes *bytes = NULL;
+	gs_unref_variant GVariant *entries = NULL;
+	GMappedFile *mapped_file;
+	struct stat st;
+	GVariantIter iter;
+	const char *version;
+	const char *path;
+	GVariant *entry;
+
+	g_return_val_if_fail (filename && filename[0] == '/', NULL);
+
+	cache = g_slice_new0 (NMSKeyfileReaderCache);
+	cache->filename = g_strdup (filename);
+	cache->entries_loaded = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+	cache->entries = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+
+	/* the cache contains secrets. Only trust it, if nobody else could have
+	 * written it. */
+	if (   stat (filename, &st) != 0
+	    || !S_ISREG (st.st_mode)
+	    || st.st_uid != geteuid ()
+	    || (st.st_mode & 0077))
+		return cache;
+
+	mapped_file = g_mapped_file_new (filename, FALSE, NULL);
+	if (!mapped_file)
+		return cache;
+	bytes = g_mapped_file_get_bytes (mapped_file);
+	g_mapped_file_unref (mapped_file);
+
+	cache->loaded = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE (CACHE_FILE_TYPE),
+	                                                              bytes,
+	                                                              FALSE));
+
+	g_variant_get (cache->loaded, "(&sa{s" CACHE_ENTRY_TYPE "})", &version, NULL);
+	if (!nm_streq (version, CACHE_VERSION)) {
+		g_clear_pointer (&cache->loaded, g_variant_unref);
+		return cache;
+	}
+
+	entries = g_variant_get_child_value (cache->loaded, 1);
+	g_variant_iter_init (&iter, entries);
+	while (g_variant_iter_next (&iter, "{&s@" CACHE_ENTRY_TYPE "}", &path, &entry))
+		g_hash_table_insert (cache->entries_loaded, g_strdup (path), entry);
+
+	return cache;
+}
+
+void
+nms_keyfile_reader_cache_free (NMSKeyfileReaderCache *cache)
+{
+	if (!cache)
+		return;
+
+	g_hash_table_unref (cache->entries);
+	g_hash_table_unref (cache->entries_loaded);
+	if (cache->loaded)
+		g_variant_unref (cache->loaded);
+	g_free (cache->filename);
+	g_slice_free (NMSKeyfileReaderCache, cache);
+}
+
+void
+nms_keyfile_reader_cache_get_stats (NMSKeyfileReaderCache *cache,
+                                    guint *out_n_hits,
+                                    guint *out_n_misses)
+{
+	g_return_if_fail (cache);
+
+	NM_SET_OUT (out_n_hits, cache->n_hits);
+	NM_SET_OUT (out_n_misses, cache->n_misses);
+}
+
+/**
+ * nms_keyfile_reader_cache_write:
+ * @cache: the cache
+ * @error: (allow-none): the error on failure
+ *
+ * Writes the cache file, containing all the connections that were
+ * read via @cache or kept with nms_keyfile_reader_cache_keep(). Entries
+ * for other files (because the files are gone) are dropped. Does nothing, if the content of the
+ * cache file would not change.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean
+nms_keyfile_reader_cache_write (NMSKeyfileReaderCache *cache,
+                                GError **error)
+{
+	gs_unref_variant GVariant *variant = NULL;
+	GVariantBuilder builder;
+	GHashTableIter iter;
+	const char *path;
+	GVariant *entry;
+
+	g_return_val_if_fail (cache, FALSE);
+
+	if (   !cache->dirty
+	    && g_hash_table_size (cache->entries) == g_hash_table_size (cache->entries_loaded))
+		return TRUE;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{s" CACHE_ENTRY_TYPE "}"));
+	g_hash_table_iter_init (&iter, cache->entries);
+	while (g_hash_table_iter_next (&iter, (gpointer *) &path, (gpointer *) &entry))
+		g_variant_builder_add (&builder, "{s@" CACHE_ENTRY_TYPE "}", path, entry);
+
+	variant = g_variant_ref_sink (g_variant_new ("(sa{s" CACHE_ENTRY_TYPE "})",
+	                                             CACHE_VERSION,
+	                                             &builder));
+
+	if (!nm_utils_file_set_contents (cache->filename,
+	                                 g_variant_get_data (variant),
+	                                 g_variant_get_size (variant),
+	                                 0600,
+	                                 error))
+		return FALSE;
+
+	cache->dirty = FALSE;
+	return TRUE;
+}
+
+static gboolean
+_cache_entry_matches (GVariant *entry, const struct stat *st)
+{
+	guint64 st_dev, st_ino;
+	gint64 st_size, st_mtim_sec;
+	guint32 st_mtim_nsec, st_mode, st_uid;
+
+	g_variant_get (entry, "(ttxxuuu@a{sa{sv}})",
+	               &st_dev, &st_ino, &st_size, &st_mtim_sec, &st_mtim_nsec, &st_mode, &st_uid,
+	               NULL);
+	return    st_dev == (guint64) st->st_dev
+	       && st_ino == (guint64) st->st_ino
+	       && st_size == (gint64) st->st_size
+	       && st_mtim_sec == (gint64) st->st_mtim.tv_sec
+	       && st_mtim_nsec == (guint32) st->st_mtim.tv_nsec
+	       && st_mode == (guint32) st->st_mode
+	       && st_uid == (guint32) st->st_uid;
+}
+
+static NMConnection *
+_cache_lookup (NMSKeyfileReaderCache *cache,
+               const char *filename,
+               const struct stat *st)
+{
+	gs_unref_variant GVariant *dict = NULL;
+	gs_free_error GError *local = NULL;
+	GVariant *entry;
+	NMConnection *connection;
+
+	entry = g_hash_table_lookup (cache->entries_loaded, filename);
+	if (   !entry
+	    || !_cache_entry_matches (entry, st))
+		return NULL;
+
+	dict = g_variant_get_child_value (entry, 7);
+	connection = _nm_simple_connection_new_from_dbus (dict, NM_SETTING_PARSE_FLAGS_STRICT, &local);
+	if (!connection) {
+		nm_log_dbg (LOGD_SETTINGS, "keyfile: cache: ignore invalid entry for \"%s\": %s", filename, local->message);
+		return NULL;
+	}
+
+	if (!nm_connection_normalize (connection, NULL, NULL, NULL)) {
+		g_object_unref (connection);
+		return NULL;
+	}
+
+	g_hash_table_insert (cache->entries, g_strdup (filename), g_variant_ref (entry));
+	return connection;
+}
+
+/**
+ * nms_keyfile_reader_cache_keep:
+ * @cache: the cache
+ * @filename: the keyfile
+ * @st: the current stat of @filename
+ *
+ * Keeps the entry of @filename in the next cache file, although the file
+ * is not read via @cache, because it did not change since it was read last.
+ *
+ * Returns: %TRUE, if @cache has a valid entry for @filename.
+ */
+gboolean
+nms_keyfile_reader_cache_keep (NMSKeyfileReaderCache *cache,
+                               const char *filename,
+                               const struct stat *st)
+{
+	GVariant *entry;
+
+	g_return_val_if_fail (cache, FALSE);
+	g_return_val_if_fail (filename, FALSE);
+
+	entry = g_hash_table_lookup (cache->entries_loaded, filename);
+	if (   !entry
+	    || !_cache_entry_matches (entry, st))
+		return FALSE;
+
+	g_hash_table_insert (cache->entries, g_strdup (filename), g_variant_ref (entry));
+	return TRUE;
+}
+
+static void
+_cache_add (NMSKeyfileReaderCache *cache,
+            const char *filename,
+            const struct stat *st,
+            NMConnection *connection)
+{
+	gs_unref_object NMConnection *reread = NULL;
+	gs_unref_variant GVariant *dict = NULL;
+
+	dict = g_variant_ref_sink (nm_connection_to_dbus (connection, NM_CONNECTION_SERIALIZE_ALL));
+
+	/* only cache connections that survive the round trip unchanged. */
+	reread = _nm_simple_connection_new_from_dbus (dict, NM_SETTING_PARSE_FLAGS_STRICT, NULL);
+	if (   !reread
+	    || !nm_connection_compare (connection, reread, NM_SETTING_COMPARE_FLAG_EXACT)) {
+		g_hash_table_remove (cache->entries, filename);
+		cache->dirty = TRUE;
+		return;
+	}
+
+	g_hash_table_insert (cache->entries,
+	                     g_strdup (filename),
+	                     g_variant_ref_sink (g_variant_new ("(ttxxuuu@a{sa{sv}})",
+	                                                        (guint64) st->st_dev,
+	                                                        (guint64) st->st_ino,
+	                                                        (gint64) st->st_size,
+	                                                        (gint64) st->st_mtim.tv_sec,
+	                                                        (guint32) st->st_mtim.tv_nsec,
+	                                                        (guint32) st->st_mode,
+	                                                        (guint32) st->st_uid,
+	                                                        dict)));
+	cache->dirty = TRUE;
+}
+
+/*****************************************************************************/
+
 NMConnection *
 nms_keyfile_reader_from_file (const char *filename, GError **error)
 {
-	gs_unref_keyfile GKeyFile *key_file = NULL;
-	struct stat statbuf;
-	NMConnection *connection = NULL;
-	GError *verify_error = NULL;
+	return nms_keyfile_reader_from_file_full (filename, NULL, NULL, NULL, error);
+}
+
+/* Templates let many similar profiles share their common settings on disk.
+ * A profile that names a template in its "template" group is read as if all
+ * groups and keys of the template were part of it, with the profile's own
+ * keys taking precedence. The parsed template is kept and reused for all
+ * profiles that are based on it, as long as the file does not change. */
+
+typedef struct {
+	struct stat st;
+	GKeyFile *keyfile;
+} TemplateEntry;
 
-	if (stat (filename, &statbuf) != 0 || !S_ISREG (statbuf.st_mode)) {
+static GHashTable *templates; /* path::TemplateEntry */
+
+static void
+_template_entry_free (gpointer data)
+{
+	TemplateEntry *entry = data;
+
+	g_key_file_unref (entry->keyfile);
+	g_slice_free (TemplateEntry, entry);
+}
+
+/**
+ * nms_keyfile_reader_templates_prune:
+ *
+ * Forgets the parsed templates whose file no longer exists.
+ */
+void
+nms_keyfile_reader_templates_prune (void)
+{
+	GHashTableIter iter;
+	const char *path;
+	struct stat st;
+
+	if (!templates)
+		return;
+
+	g_hash_table_iter_init (&iter, templates);
+	while (g_hash_table_iter_next (&iter, (gpointer *) &path, NULL)) {
+		if (stat (path, &st) != 0)
+			g_hash_table_iter_remove (&iter);
+	}
+}
+
+/**
+ * nms_keyfile_reader_templates_clear:
+ *
+ * Forgets all parsed templates.
+ */
+void
+nms_keyfile_reader_templates_clear (void)
+{
+	g_clear_pointer (&templates, g_hash_table_destroy);
+}
+
+static gboolean
+_check_file (const char *filename, struct stat *out_st, GError **error)
+{
+	if (stat (filename, out_st) != 0 || !S_ISREG (out_st->st_mode)) {
 		g_set_error_literal (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION,
 		                     "File did not exist or was not a regular file");
-		return NULL;
+		return FALSE;
 	}
 
 	if (!NM_FLAGS_HAS (nm_utils_get_testing (), NM_UTILS_TEST_NO_KEYFILE_OWNER_CHECK)) {
-		if (statbuf.st_mode & 0077) {
+		if (out_st->st_mode & 0077) {
 			g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION,
 			             "File permissions (%o) were insecure",
-			             statbuf.st_mode);
-			return NULL;
+			             out_st->st_mode);
+			return FALSE;
 		}
 
-		if (statbuf.st_uid != 0) {
+		if (out_st->st_uid != 0) {
 			g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION,
 			             "File owner (%o) is insecure",
-			             statbuf.st_mode);
-			return NULL;
+			             out_st->st_mode);
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+static GKeyFile *
+_template_get (const char *filename, const char *name, GError **error)
+{
+	gs_free char *dirname = NULL;
+	gs_free char *path = NULL;
+	gs_unref_keyfile GKeyFile *keyfile = NULL;
+	TemplateEntry *entry;
+	struct stat st;
+	GError *local = NULL;
+
+	if (   !name[0]
+	    || strchr (name, '/')
+	    || name[0] == '.') {
+		g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION,
+		             "invalid template name '%s'", name);
+		return NULL;
+	}
+
+	dirname = g_path_get_dirname (filename);
+	path = g_strdup_printf ("%s/%s" NMS_KEYFILE_TEMPLATE_SUFFIX, dirname, name);
+
+	if (!_check_file (path, &st, &local)) {
+		g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION,
+		             "cannot read template '%s': %s", path, local->message);
+		g_error_free (local);
+		return NULL;
+	}
+
+	if (templates) {
+		entry = g_hash_table_lookup (templates, path);
+		if (   entry
+		    && entry->st.st_dev == st.st_dev
+		    && entry->st.st_ino == st.st_ino
+		    && entry->st.st_size == st.st_size
+		    && entry->st.st_mtim.tv_sec == st.st_mtim.tv_sec
+		    && entry->st.st_mtim.tv_nsec == st.st_mtim.tv_nsec)
+			return entry->keyfile;
+	}
+
+	keyfile = g_key_file_new ();
+	if (!g_key_file_load_from_file (keyfile, path, G_KEY_FILE_NONE, &local)) {
+		g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION,
+		             "cannot read template '%s': %s", path, local->message);
+		g_error_free (local);
+		return NULL;
+	}
+
+	/* a template cannot be based on another template, and it must not
+	 * give all profiles based on it the same UUID. */
+	g_key_file_remove_group (keyfile, NMS_KEYFILE_GROUP_TEMPLATE, NULL);
+	g_key_file_remove_key (keyfile, NM_SETTING_CONNECTION_SETTING_NAME, NM_SETTING_CONNECTION_UUID, NULL);
+
+	if (G_UNLIKELY (!templates))
+		templates = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, _template_entry_free);
+
+	entry = g_slice_new (TemplateEntry);
+	entry->st = st;
+	entry->keyfile = g_steal_pointer (&keyfile);
+	g_hash_table_insert (templates, g_steal_pointer (&path), entry);
+	return entry->keyfile;
+}
+
+static void
+_keyfile_copy_into (GKeyFile *dst, GKeyFile *src)
+{
+	gs_strfreev char **groups = NULL;
+	gsize i, j;
+
+	groups = g_key_file_get_groups (src, NULL);
+	for (i = 0; groups[i]; i++) {
+		gs_strfreev char **keys = NULL;
+
+		if (nm_streq (groups[i], NMS_KEYFILE_GROUP_TEMPLATE))
+			continue;
+
+		keys = g_key_file_get_keys (src, groups[i], NULL, NULL);
+		if (!keys)
+			continue;
+		for (j = 0; keys[j]; j++) {
+			gs_free char *value = NULL;
+
+			value = g_key_file_get_value (src, groups[i], keys[j], NULL);
+			if (value)
+				g_key_file_set_value (dst, groups[i], keys[j], value);
+		}
+	}
+}
+
+/* If @key_file is based on a template, returns a new keyfile with the
+ * template applied. Returns %NULL with @error unset, if there is no
+ * template. */
+static GKeyFile *
+_template_apply (GKeyFile *key_file, const char *filename, GError **error)
+{
+	gs_free char *name = NULL;
+	GKeyFile *template;
+	GKeyFile *merged;
+
+	name = g_key_file_get_string (key_file, NMS_KEYFILE_GROUP_TEMPLATE, "name", NULL);
+	if (!name) {
+		if (g_key_file_has_group (key_file, NMS_KEYFILE_GROUP_TEMPLATE)) {
+			g_set_error_literal (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION,
+			                     "template group without name");
+		}
+		return NULL;
+	}
+
+	template = _template_get (filename, name, error);
+	if (!template)
+		return NULL;
+
+	merged = g_key_file_new ();
+	_keyfile_copy_into (merged, template);
+	_keyfile_copy_into (merged, key_file);
+	return merged;
+}
+
+/*****************************************************************************/
+
+/* nms_keyfile_reader_from_file_full:
+ * @filename: the keyfile to read
+ * @cache: (allow-none): the reader cache to use
+ * @out_st: (allow-none): on success, the stat of @filename taken
+ *   before it was read.
+ * @out_templated: (allow-none): on success, whether the profile is based
+ *   on a template. The stat of @filename alone then does not tell whether
+ *   the profile changed.
+ * @error: the error in case of failure
+ */
+NMConnection *
+nms_keyfile_reader_from_file_full (const char *filename,
+                                   NMSKeyfileReaderCache *cache,
+                                   struct stat *out_st,
+                                   gboolean *out_templated,
+                                   GError **error)
+{
+	gs_unref_keyfile GKeyFile *key_file = NULL;
+	gs_unref_keyfile GKeyFile *merged = NULL;
+	struct stat statbuf;
+	NMConnection *connection = NULL;
+	GError *verify_error = NULL;
+	GError *local = NULL;
+
+	if (!_check_file (filename, &statbuf, error))
+		return NULL;
+
+	if (cache) {
+		connection = _cache_lookup (cache, filename, &statbuf);
+		if (connection) {
+			cache->n_hits++;
+			NM_SET_OUT (out_st, statbuf);
+			NM_SET_OUT (out_templated, FALSE);
+			return connection;
 		}
+		cache->n_misses++;
 	}
 
 	key_file = g_key_file_new ();
 	if (!g_key_file_load_from_file (key_file, filename, G_KEY_FILE_NONE, error))
 		return NULL;
 
-	connection = nms_keyfile_reader_from_keyfile (key_file, filename, TRUE, error);
+	merged = _template_apply (key_file, filename, &local);
+	if (local) {
+		g_propagate_error (error, local);
+		return NULL;
+	}
+
+	connection = nms_keyfile_reader_from_keyfile (merged ?: key_file, filename, TRUE, error);
 	if (!connection)
 		return NULL;
 
@@ -157,9 +648,15 @@ nms_keyfile_reader_from_file (const char *filename, GError **error)
 		             verify_error->message);
 		g_clear_error (&verify_error);
 		g_object_unref (connection);
-		connection = NULL;
+		return NULL;
 	}
 
+	/* a cached entry is only validated against the profile's own file,
+	 * so profiles based on a template are not cached. */
+	if (cache && !merged)
+		_cache_add (cache, filename, &statbuf, connection);
+
+	NM_SET_OUT (out_st, statbuf);
+	NM_SET_OUT (out_templated, !!merged);
 	return connection;
 }
-
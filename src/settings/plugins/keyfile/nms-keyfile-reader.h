@@ -22,6 +22,8 @@
 #ifndef __NMS_KEYFILE_READER_H__
 #define __NMS_KEYFILE_READER_H__
 
+#include <sys/stat.h>
+
 #include "nm-connection.h"
 
 NMConnection *nms_keyfile_reader_from_keyfile (GKeyFile *key_file,
@@ -31,4 +33,25 @@ NMConnection *nms_keyfile_reader_from_keyfile (GKeyFile *key_file,
 
 NMConnection *nms_keyfile_reader_from_file (const char *filename, GError **error);
 
+typedef struct _NMSKeyfileReaderCache NMSKeyfileReaderCache;
+
+NMSKeyfileReaderCache *nms_keyfile_reader_cache_new (const char *filename);
+void nms_keyfile_reader_cache_free (NMSKeyfileReaderCache *cache);
+gboolean nms_keyfile_reader_cache_write (NMSKeyfileReaderCache *cache, GError **error);
+void nms_keyfile_reader_cache_get_stats (NMSKeyfileReaderCache *cache,
+                                         guint *out_n_hits,
+                                         guint *out_n_misses);
+gboolean nms_keyfile_reader_cache_keep (NMSKeyfileReaderCache *cache,
+                                        const char *filename,
+                                        const struct stat *st);
+
+NMConnection *nms_keyfile_reader_from_file_full (const char *filename,
+                                                 NMSKeyfileReaderCache *cache,
+                                                 struct stat *out_st,
+                                                 gboolean *out_templated,
+                                                 GError **error);
+
+void nms_keyfile_reader_templates_prune (void);
+void nms_keyfile_reader_templates_clear (void);
+
 #endif /* __NMS_KEYFILE_READER_H__ */
@@ -88,6 +88,7 @@ check_suffix (const char *base, const char *tag)
 #define SWPX_TAG ".swpx"
 #define PEM_TAG ".pem"
 #define DER_TAG ".der"
+#define TEMPLATE_TAG NMS_KEYFILE_TEMPLATE_SUFFIX
 
 gboolean
 nms_keyfile_utils_should_ignore_file (const char *filename)
@@ -109,6 +110,9 @@ nms_keyfile_utils_should_ignore_file (const char *filename)
 	/* Ignore 802.1x certificates and keys */
 	if (check_suffix (base, PEM_TAG) || check_suffix (base, DER_TAG))
 		return TRUE;
+	/* Ignore templates, they are only read via the profiles that use them */
+	if (check_suffix (base, TEMPLATE_TAG))
+		return TRUE;
 
 	return FALSE;
 }
@@ -144,7 +148,8 @@ nms_keyfile_utils_escape_filename (const char *filename)
 		str->str[str->len - 1] = ESCAPE_CHAR2;
 	if (   check_mkstemp_suffix (str->str)
 	    || check_suffix (str->str, PEM_TAG)
-	    || check_suffix (str->str, DER_TAG))
+	    || check_suffix (str->str, DER_TAG)
+	    || check_suffix (str->str, TEMPLATE_TAG))
 		g_string_append_c (str, ESCAPE_CHAR2);
 
 	return g_string_free (str, FALSE);;
@@ -25,6 +25,11 @@
 
 #define NM_CONFIG_KEYFILE_PATH_IN_MEMORY NMRUNDIR "/system-connections"
 
+/* A profile can be based on a template, by naming it in the "template" group.
+ * The template is a keyfile with this suffix in the same directory. */
+#define NMS_KEYFILE_GROUP_TEMPLATE       "template"
+#define NMS_KEYFILE_TEMPLATE_SUFFIX      ".nmtemplate"
+
 #define NMS_KEYFILE_CONNECTION_LOG_PATH(path)  ((path) ?: "in-memory")
 #define NMS_KEYFILE_CONNECTION_LOG_FMT         "%s (%s,\"%s\")"
 #define NMS_KEYFILE_CONNECTION_LOG_ARG(con)    NMS_KEYFILE_CONNECTION_LOG_PATH (nm_settings_connection_get_filename ((NMSettingsConnection *) (con))), nm_settings_connection_get_uuid ((NMSettingsConnection *) (con)), nm_settings_connection_get_id ((NMSettingsConnection *) (con))
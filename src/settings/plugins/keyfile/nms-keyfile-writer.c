@@ -25,6 +25,7 @@
 
 #include <stdlib.h>
 #include <sys/stat.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
@@ -38,6 +39,261 @@
 
 /*****************************************************************************/
 
+typedef struct {
+	char *tmp_path;
+	char *path;
+
+	/* for a certificate blob, the path of the keyfile that references it. */
+	char *owner_path;
+} PendingWrite;
+
+/* State of the write batch, see nms_keyfile_writer_batch_begin(). */
+static struct {
+	guint depth;
+	GArray *pending;
+	GHashTable *pending_paths;
+} write_batch;
+
+static void
+_pending_write_clear (gpointer data)
+{
+	PendingWrite *pending = data;
+
+	g_free (pending->tmp_path);
+	g_free (pending->path);
+	g_free (pending->owner_path);
+}
+
+static gboolean
+_file_exists (const char *path)
+{
+	if (   write_batch.pending_paths
+	    && g_hash_table_contains (write_batch.pending_paths, path))
+		return TRUE;
+	return g_file_test (path, G_FILE_TEST_EXISTS);
+}
+
+static gboolean
+_write_file (const char *path,
+             const char *data,
+             gsize len,
+             gboolean set_owner,
+             uid_t owner_uid,
+             pid_t owner_grp,
+             GError **error)
+{
+	gs_free char *tmp_path = NULL;
+	GError *local = NULL;
+	const char *written_path;
+	PendingWrite *pending;
+	int errsv;
+
+	if (!write_batch.depth) {
+		if (!nm_utils_file_set_contents (path, data, len, 0600, &local)) {
+			g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_FAILED,
+			             "error writing to file '%s': %s",
+			             path, local->message);
+			g_error_free (local);
+			return FALSE;
+		}
+		written_path = path;
+	} else {
+		/* only write a temporary file. It gets synced and renamed to @path
+		 * when the batch ends. */
+		if (!nm_utils_file_write_tmp (path, data, len, 0600, &tmp_path, &local)) {
+			g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_FAILED,
+			             "error writing to file '%s': %s",
+			             path, local->message);
+			g_error_free (local);
+			return FALSE;
+		}
+		written_path = tmp_path;
+	}
+
+	if (   set_owner
+	    && chown (written_path, owner_uid, owner_grp) < 0) {
+		errsv = errno;
+		g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_FAILED,
+		             "error chowning '%s': %s (%d)",
+		             path, g_strerror (errsv), errsv);
+		unlink (written_path);
+		return FALSE;
+	}
+
+	if (tmp_path) {
+		g_array_set_size (write_batch.pending, write_batch.pending->len + 1);
+		pending = &g_array_index (write_batch.pending, PendingWrite, write_batch.pending->len - 1);
+		pending->tmp_path = g_steal_pointer (&tmp_path);
+		pending->path = g_strdup (path);
+		g_hash_table_add (write_batch.pending_paths, pending->path);
+	}
+
+	return TRUE;
+}
+
+/**
+ * nms_keyfile_writer_batch_begin:
+ *
+ * Starts a batch of writes. Until the matching nms_keyfile_writer_batch_end(),
+ * files are only written to temporary files, without syncing them to disk.
+ * Batches can be nested, only the outermost one has an effect.
+ */
+void
+nms_keyfile_writer_batch_begin (void)
+{
+	if (write_batch.depth++ > 0)
+		return;
+
+	write_batch.pending = g_array_new (FALSE, TRUE, sizeof (PendingWrite));
+	g_array_set_clear_func (write_batch.pending, _pending_write_clear);
+	write_batch.pending_paths = g_hash_table_new (nm_str_hash, g_str_equal);
+}
+
+static void
+_batch_failed (GHashTable **failed, const PendingWrite *p, const char *what, int errsv)
+{
+	const char *path = p->owner_path ?: p->path;
+
+	if (!*failed)
+		*failed = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, g_free);
+	if (g_hash_table_contains (*failed, path))
+		return;
+	g_hash_table_insert (*failed,
+	                     g_strdup (path),
+	                     g_strdup_printf ("error %s file '%s': %s",
+	                                      what, p->path, g_strerror (errsv)));
+}
+
+static int
+_sync_dir (const char *dir, gboolean whole_fs)
+{
+	int fd;
+	int errsv = 0;
+
+	fd = open (dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd < 0)
+		return errno;
+	if ((whole_fs ? syncfs (fd) : fsync (fd)) != 0)
+		errsv = errno;
+	nm_close (fd);
+	return errsv;
+}
+
+/**
+ * nms_keyfile_writer_batch_end:
+ *
+ * Ends a batch of writes started with nms_keyfile_writer_batch_begin().
+ * The file system of each written file is synced once with syncfs(), and
+ * only then the temporary files are renamed to their final names. That
+ * gives the same guarantees as the fsync() before the rename in
+ * nm_utils_file_set_contents(), with one sync for all files. Finally,
+ * each directory is fsync()ed once, so that the renames are durable too.
+ *
+ * Returns: (transfer full): %NULL if all files of the batch were saved.
+ *   Otherwise a hash table that maps the path of each keyfile that could
+ *   not be saved to an error message. A failure to save a certificate
+ *   blob is reported for the keyfile that references it. A nested batch
+ *   always returns %NULL.
+ */
+GHashTable *
+nms_keyfile_writer_batch_end (void)
+{
+	gs_unref_array GArray *pending = NULL;
+	gs_unref_hashtable GHashTable *pending_paths = NULL;
+	gs_unref_hashtable GHashTable *dirs = NULL;
+	GHashTable *failed = NULL;
+	GHashTableIter iter;
+	const char *dir;
+	gpointer errsv_ptr;
+	guint i;
+	int errsv;
+
+	g_return_val_if_fail (write_batch.depth > 0, NULL);
+
+	if (--write_batch.depth > 0)
+		return NULL;
+
+	pending = g_steal_pointer (&write_batch.pending);
+	pending_paths = g_steal_pointer (&write_batch.pending_paths);
+
+	if (pending->len == 0)
+		return NULL;
+
+	/* dir::errno of syncing it, 0 on success. */
+	dirs = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, NULL);
+
+	for (i = 0; i < pending->len; i++) {
+		const PendingWrite *p = &g_array_index (pending, PendingWrite, i);
+		char *d;
+
+		d = g_path_get_dirname (p->path);
+		if (g_hash_table_contains (dirs, d)) {
+			g_free (d);
+			continue;
+		}
+
+		errsv = _sync_dir (d, TRUE);
+		if (errsv) {
+			nm_log_warn (LOGD_SETTINGS, "keyfile: failed to sync %s: %s",
+			             d, g_strerror (errsv));
+		}
+		g_hash_table_insert (dirs, d, GINT_TO_POINTER (errsv));
+	}
+
+	for (i = 0; i < pending->len; i++) {
+		const PendingWrite *p = &g_array_index (pending, PendingWrite, i);
+		gs_free char *d = NULL;
+
+		d = g_path_get_dirname (p->path);
+		errsv = GPOINTER_TO_INT (g_hash_table_lookup (dirs, d));
+		if (errsv) {
+			/* like nm_utils_file_set_contents(), don't replace the old file
+			 * when the new content could not be made durable. */
+			nm_log_warn (LOGD_SETTINGS, "keyfile: not saving %s, data could not be synced",
+			             p->path);
+			unlink (p->tmp_path);
+			_batch_failed (&failed, p, "syncing", errsv);
+			continue;
+		}
+
+		if (rename (p->tmp_path, p->path) != 0) {
+			errsv = errno;
+			nm_log_warn (LOGD_SETTINGS, "keyfile: failed to rename %s to %s: %s",
+			             p->tmp_path, p->path, g_strerror (errsv));
+			unlink (p->tmp_path);
+			_batch_failed (&failed, p, "writing to", errsv);
+		}
+	}
+
+	/* make the new directory entries durable. */
+	g_hash_table_iter_init (&iter, dirs);
+	while (g_hash_table_iter_next (&iter, (gpointer *) &dir, &errsv_ptr)) {
+		if (GPOINTER_TO_INT (errsv_ptr))
+			continue;
+
+		errsv = _sync_dir (dir, FALSE);
+		if (!errsv)
+			continue;
+
+		nm_log_warn (LOGD_SETTINGS, "keyfile: failed to sync directory %s: %s",
+		             dir, g_strerror (errsv));
+		for (i = 0; i < pending->len; i++) {
+			const PendingWrite *p = &g_array_index (pending, PendingWrite, i);
+			gs_free char *d = NULL;
+
+			d = g_path_get_dirname (p->path);
+			if (nm_streq (d, dir))
+				_batch_failed (&failed, p, "syncing", errsv);
+		}
+	}
+
+	nm_log_dbg (LOGD_SETTINGS, "keyfile: synced %u files in batch (%u failed)",
+	            pending->len, failed ? g_hash_table_size (failed) : 0u);
+	return failed;
+}
+
+/*****************************************************************************/
+
 typedef struct {
 	const char *keyfile_dir;
 } WriteInfo;
@@ -129,8 +385,8 @@ cert_writer (NMConnection *connection,
 		new_path = g_strdup_printf ("%s/%s-%s.%s", info->keyfile_dir, nm_connection_get_uuid (connection),
 		                            cert_data->vtable->file_suffix, ext);
 
-		success = nm_utils_file_set_contents (new_path, (const char *) blob_data,
-		                                      blob_len, 0600, &local);
+		success = _write_file (new_path, (const char *) blob_data, blob_len,
+		                       FALSE, 0, 0, &local);
 		if (success) {
 			/* Write the path value to the keyfile.
 			 * We know, that basename(new_path) starts with a UUID, hence no conflict with "data:;base64,"  */
@@ -187,9 +443,8 @@ _internal_write_connection (NMConnection *connection,
 	gs_free char *path = NULL;
 	const char *id;
 	WriteInfo info = { 0 };
-	GError *local_err = NULL;
-	int errsv;
 	gboolean rename = force_rename;
+	guint pending_start;
 
 	g_return_val_if_fail (!out_path || !*out_path, FALSE);
 	g_return_val_if_fail (keyfile_dir && keyfile_dir[0] == '/', FALSE);
@@ -212,6 +467,9 @@ _internal_write_connection (NMConnection *connection,
 
 	info.keyfile_dir = keyfile_dir;
 
+	/* certificate blobs are written while creating the keyfile. */
+	pending_start = write_batch.depth ? write_batch.pending->len : 0;
+
 	key_file = nm_keyfile_write (connection, _handler_write, &info, error);
 	if (!key_file)
 		return FALSE;
@@ -241,7 +499,7 @@ _internal_write_connection (NMConnection *connection,
 	 * there's a race here, but there's not a lot we can do about it, and
 	 * we shouldn't get more than one connection with the same UUID either.
 	 */
-	if (g_strcmp0 (path, existing_path) != 0 && g_file_test (path, G_FILE_TEST_EXISTS)) {
+	if (g_strcmp0 (path, existing_path) != 0 && _file_exists (path)) {
 		guint i;
 		gboolean name_found = FALSE;
 
@@ -260,7 +518,7 @@ _internal_write_connection (NMConnection *connection,
 			path = g_strdup_printf ("%s/%s", keyfile_dir, filename_escaped);
 			g_free (filename);
 			g_free (filename_escaped);
-			if (g_strcmp0 (path, existing_path) == 0 || !g_file_test (path, G_FILE_TEST_EXISTS)) {
+			if (g_strcmp0 (path, existing_path) == 0 || !_file_exists (path)) {
 				name_found = TRUE;
 				break;
 			}
@@ -285,22 +543,20 @@ _internal_write_connection (NMConnection *connection,
 	if (existing_path != NULL && strcmp (path, existing_path) != 0)
 		unlink (existing_path);
 
-	nm_utils_file_set_contents (path, data, len, 0600, &local_err);
-	if (local_err) {
-		g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_FAILED,
-		             "error writing to file '%s': %s",
-		             path, local_err->message);
-		g_error_free (local_err);
+	if (!_write_file (path, data, len, TRUE, owner_uid, owner_grp, error))
 		return FALSE;
-	}
 
-	if (chown (path, owner_uid, owner_grp) < 0) {
-		errsv = errno;
-		g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_FAILED,
-		             "error chowning '%s': %s (%d)",
-		             path, g_strerror (errsv), errsv);
-		unlink (path);
-		return FALSE;
+	if (write_batch.depth) {
+		guint i;
+
+		/* a blob that fails to be saved at the end of the batch fails
+		 * the profile that references it. */
+		for (i = pending_start; i < write_batch.pending->len; i++) {
+			PendingWrite *pending = &g_array_index (write_batch.pending, PendingWrite, i);
+
+			if (!nm_streq (pending->path, path))
+				pending->owner_path = g_strdup (path);
+		}
 	}
 
 	if (out_reread || out_reread_same)
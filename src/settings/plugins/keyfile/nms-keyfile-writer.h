@@ -42,4 +42,7 @@ gboolean nms_keyfile_writer_test_connection (NMConnection *connection,
                                              gboolean *out_reread_same,
                                              GError **error);
 
+void nms_keyfile_writer_batch_begin (void);
+GHashTable *nms_keyfile_writer_batch_end (void);
+
 #endif /* __NMS_KEYFILE_WRITER_H__ */
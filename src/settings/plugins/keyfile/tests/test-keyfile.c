@@ -2383,6 +2383,47 @@ test_read_missing_id_uuid (void)
 	g_assert (nm_connection_get_uuid (connection));
 }
 
+static void
+test_read_template (void)
+{
+	gs_unref_object NMConnection *connection = NULL;
+	gs_free_error GError *error = NULL;
+	NMSettingConnection *s_con;
+	NMSettingVlan *s_vlan;
+	NMSettingIPConfig *s_ip4;
+
+	connection = nms_keyfile_reader_from_file (TEST_KEYFILES_DIR"/Test_Template_Instance", &error);
+	nmtst_assert_success (connection, error);
+	nmtst_assert_connection_verifies_without_normalization (connection);
+
+	/* the profile's own keys... */
+	s_con = nm_connection_get_setting_connection (connection);
+	g_assert_cmpstr (nm_setting_connection_get_id (s_con), ==, "Test Template Instance");
+	g_assert_cmpstr (nm_setting_connection_get_uuid (s_con), ==, "8d5b0c67-9a3b-4e7c-a5a0-2f8b4d0b9a41");
+	g_assert_cmpstr (nm_setting_connection_get_interface_name (s_con), ==, "eth0.100");
+
+	/* ... are combined with the ones from the template */
+	g_assert_cmpstr (nm_setting_connection_get_connection_type (s_con), ==, NM_SETTING_VLAN_SETTING_NAME);
+	g_assert (!nm_setting_connection_get_autoconnect (s_con));
+
+	s_vlan = nm_connection_get_setting_vlan (connection);
+	g_assert (s_vlan);
+	g_assert_cmpint (nm_setting_vlan_get_id (s_vlan), ==, 100);
+	g_assert_cmpstr (nm_setting_vlan_get_parent (s_vlan), ==, "eth0");
+
+	s_ip4 = nm_connection_get_setting_ip4_config (connection);
+	g_assert (s_ip4);
+	g_assert_cmpstr (nm_setting_ip_config_get_method (s_ip4), ==, NM_SETTING_IP4_CONFIG_METHOD_MANUAL);
+	g_assert_cmpint (nm_setting_ip_config_get_num_addresses (s_ip4), ==, 1);
+	g_assert_cmpint (nm_setting_ip_config_get_num_dns (s_ip4), ==, 1);
+	g_assert_cmpstr (nm_setting_ip_config_get_dns (s_ip4, 0), ==, "192.168.1.1");
+	g_clear_object (&connection);
+
+	connection = nms_keyfile_reader_from_file (TEST_KEYFILES_DIR"/Test_Template_Missing", &error);
+	g_assert_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION);
+	g_assert (!connection);
+}
+
 static void
 test_read_minimal (void)
 {
@@ -2750,6 +2791,169 @@ test_nm_keyfile_plugin_utils_escape_filename (void)
 
 /*****************************************************************************/
 
+static void
+_reader_cache_read (const char *cache_file,
+                    const char *testfile,
+                    guint expected_hits,
+                    NMConnection **out_connection)
+{
+	NMSKeyfileReaderCache *cache;
+	gs_free_error GError *error = NULL;
+	guint n_hits, n_misses;
+
+	cache = nms_keyfile_reader_cache_new (cache_file);
+	g_assert (cache);
+
+	*out_connection = nms_keyfile_reader_from_file_full (testfile, cache, NULL, NULL, &error);
+	g_assert_no_error (error);
+	nmtst_assert_connection_verifies_without_normalization (*out_connection);
+
+	nms_keyfile_reader_cache_get_stats (cache, &n_hits, &n_misses);
+	g_assert_cmpint (n_hits, ==, expected_hits);
+	g_assert_cmpint (n_misses, ==, 1 - expected_hits);
+
+	if (!nms_keyfile_reader_cache_write (cache, &error))
+		g_assert_not_reached ();
+	g_assert_no_error (error);
+	nms_keyfile_reader_cache_free (cache);
+}
+
+static void
+test_reader_cache (void)
+{
+	const char *cache_file = TEST_SCRATCH_DIR"/test-reader-cache";
+	gs_unref_object NMConnection *connection = NULL;
+	gs_unref_object NMConnection *con1 = NULL;
+	gs_unref_object NMConnection *con2 = NULL;
+	gs_unref_object NMConnection *con3 = NULL;
+	gs_free char *testfile = NULL;
+	NMSettingIPConfig *s_ip4;
+	NMIPAddress *addr;
+	FILE *f;
+
+	connection = nmtst_create_minimal_connection ("Test Reader Cache",
+	                                              NULL,
+	                                              NM_SETTING_WIRED_SETTING_NAME,
+	                                              NULL);
+	s_ip4 = NM_SETTING_IP_CONFIG (nm_setting_ip4_config_new ());
+	g_object_set (s_ip4,
+	              NM_SETTING_IP_CONFIG_METHOD, NM_SETTING_IP4_CONFIG_METHOD_MANUAL,
+	              NM_SETTING_IP_CONFIG_GATEWAY, "192.168.1.1",
+	              NULL);
+	addr = nm_ip_address_new (AF_INET, "192.168.1.5", 24, NULL);
+	nm_setting_ip_config_add_address (s_ip4, addr);
+	nm_ip_address_unref (addr);
+	nm_connection_add_setting (connection, NM_SETTING (s_ip4));
+	nmtst_connection_normalize (connection);
+
+	write_test_connection (connection, &testfile);
+
+	unlink (cache_file);
+
+	/* the first read populates the cache, the second one is served from it. */
+	_reader_cache_read (cache_file, testfile, 0, &con1);
+	nmtst_assert_connection_equals (connection, FALSE, con1, FALSE);
+
+	_reader_cache_read (cache_file, testfile, 1, &con2);
+	nmtst_assert_connection_equals (con1, FALSE, con2, FALSE);
+
+	/* modifying the file invalidates the entry. */
+	f = fopen (testfile, "a");
+	g_assert (f);
+	fputs ("\n# modified\n", f);
+	fclose (f);
+
+	_reader_cache_read (cache_file, testfile, 0, &con3);
+	nmtst_assert_connection_equals (con1, FALSE, con3, FALSE);
+
+	unlink (testfile);
+	unlink (cache_file);
+}
+
+static void
+test_reader_cache_keep (void)
+{
+	const char *cache_file = TEST_SCRATCH_DIR"/test-reader-cache-keep";
+	gs_unref_object NMConnection *connection = NULL;
+	gs_unref_object NMConnection *con1 = NULL;
+	gs_unref_object NMConnection *con2 = NULL;
+	gs_free char *testfile = NULL;
+	gs_free_error GError *error = NULL;
+	NMSKeyfileReaderCache *cache;
+	struct stat st;
+
+	connection = nmtst_create_minimal_connection ("Test Reader Cache Keep",
+	                                              NULL,
+	                                              NM_SETTING_WIRED_SETTING_NAME,
+	                                              NULL);
+	nmtst_connection_normalize (connection);
+
+	write_test_connection (connection, &testfile);
+
+	unlink (cache_file);
+
+	/* the initial load populates the cache. */
+	_reader_cache_read (cache_file, testfile, 0, &con1);
+
+	/* a reload skips the unchanged file and only keeps its entry. */
+	if (stat (testfile, &st) != 0)
+		g_assert_not_reached ();
+	cache = nms_keyfile_reader_cache_new (cache_file);
+	g_assert (nms_keyfile_reader_cache_keep (cache, testfile, &st));
+	if (!nms_keyfile_reader_cache_write (cache, &error))
+		g_assert_not_reached ();
+	g_assert_no_error (error);
+	nms_keyfile_reader_cache_free (cache);
+
+	/* the next start still hits the entry. */
+	_reader_cache_read (cache_file, testfile, 1, &con2);
+	nmtst_assert_connection_equals (con1, FALSE, con2, FALSE);
+
+	unlink (testfile);
+	unlink (cache_file);
+}
+
+static void
+test_write_batch (void)
+{
+	gs_unref_hashtable GHashTable *failed = NULL;
+	char *testfile[3] = { };
+	guint i;
+
+	nms_keyfile_writer_batch_begin ();
+
+	for (i = 0; i < G_N_ELEMENTS (testfile); i++) {
+		gs_unref_object NMConnection *connection = NULL;
+
+		/* the last two profiles share the same name and must not end up in
+		 * the same file, although the first one is not yet on disk. */
+		connection = nmtst_create_minimal_connection (i == 0 ? "Test Write Batch" : "Test Write Batch 2",
+		                                              NULL,
+		                                              NM_SETTING_WIRED_SETTING_NAME,
+		                                              NULL);
+		nmtst_connection_normalize (connection);
+		write_test_connection_reread (connection, &testfile[i], NULL, NULL);
+		g_assert (!g_file_test (testfile[i], G_FILE_TEST_EXISTS));
+	}
+
+	g_assert_cmpstr (testfile[1], !=, testfile[2]);
+
+	failed = nms_keyfile_writer_batch_end ();
+	g_assert (!failed);
+
+	for (i = 0; i < G_N_ELEMENTS (testfile); i++) {
+		gs_unref_object NMConnection *reread = NULL;
+
+		g_assert (g_file_test (testfile[i], G_FILE_TEST_IS_REGULAR));
+		reread = keyfile_read_connection_from_file (testfile[i]);
+		g_assert (reread);
+		unlink (testfile[i]);
+		g_free (testfile[i]);
+	}
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int main (int argc, char **argv)
@@ -2818,6 +3022,7 @@ int main (int argc, char **argv)
 	g_test_add_func ("/keyfile/test_read_missing_vlan_setting", test_read_missing_vlan_setting);
 	g_test_add_func ("/keyfile/test_read_missing_vlan_flags", test_read_missing_vlan_flags);
 	g_test_add_func ("/keyfile/test_read_missing_id_uuid", test_read_missing_id_uuid);
+	g_test_add_func ("/keyfile/test_read_template", test_read_template);
 
 	g_test_add_func ("/keyfile/test_read_minimal", test_read_minimal);
 	g_test_add_func ("/keyfile/test_read_minimal_slave", test_read_minimal_slave);
@@ -2832,6 +3037,10 @@ int main (int argc, char **argv)
 
 	g_test_add_func ("/keyfile/test_nm_keyfile_plugin_utils_escape_filename", test_nm_keyfile_plugin_utils_escape_filename);
 
+	g_test_add_func ("/keyfile/test_reader_cache", test_reader_cache);
+	g_test_add_func ("/keyfile/test_reader_cache_keep", test_reader_cache_keep);
+	g_test_add_func ("/keyfile/test_write_batch", test_write_batch);
+
 	return g_test_run ();
 }
 
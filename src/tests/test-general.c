@@ -22,12 +22,15 @@
 
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 /* need math.h for isinf() and INFINITY. No need to link with -lm */
 #include <math.h>
 
 #include "NetworkManagerUtils.h"
 #include "nm-core-internal.h"
+#include "nm-dispatcher.h"
 
 #include "nm-test-utils-core.h"
 
@@ -1845,6 +1848,136 @@ test_nm_utils_exp10 (void)
 
 /*****************************************************************************/
 
+static void
+_latency_stats_get (const char *name,
+                    guint64 *out_count,
+                    guint64 *out_max_ns,
+                    guint64 *out_buckets)
+{
+	gs_unref_variant GVariant *stats = NULL;
+	gs_unref_variant GVariant *entry = NULL;
+	gs_unref_variant GVariant *buckets = NULL;
+	const guint64 *b;
+	gsize n_buckets;
+	guint64 total_ns;
+	guint64 sum = 0;
+	guint i;
+
+	stats = g_variant_ref_sink (nm_latency_stats_to_variant ());
+	entry = g_variant_lookup_value (stats, name, G_VARIANT_TYPE ("(tttat)"));
+	g_assert (entry);
+
+	g_variant_get (entry, "(ttt@at)", out_count, &total_ns, out_max_ns, &buckets);
+	g_assert_cmpuint (total_ns, >=, *out_max_ns);
+
+	b = g_variant_get_fixed_array (buckets, &n_buckets, sizeof (guint64));
+	g_assert_cmpint (n_buckets, ==, NM_LATENCY_HISTOGRAM_BUCKETS);
+	for (i = 0; i < n_buckets; i++) {
+		out_buckets[i] = b[i];
+		sum += b[i];
+	}
+	g_assert_cmpuint (sum, ==, *out_count);
+}
+
+static void
+test_latency_stats (void)
+{
+	guint64 count1, count2;
+	guint64 max_ns1, max_ns2;
+	guint64 buckets1[NM_LATENCY_HISTOGRAM_BUCKETS];
+	guint64 buckets2[NM_LATENCY_HISTOGRAM_BUCKETS];
+	gint64 now_ns;
+	guint i;
+
+	g_assert_cmpint (nm_latency_bucket_index (0), ==, 0);
+	g_assert_cmpint (nm_latency_bucket_index (1), ==, 1);
+	g_assert_cmpint (nm_latency_bucket_index (2), ==, 2);
+	g_assert_cmpint (nm_latency_bucket_index (3), ==, 2);
+	g_assert_cmpint (nm_latency_bucket_index (4), ==, 3);
+	g_assert_cmpint (nm_latency_bucket_index (1023), ==, 10);
+	g_assert_cmpint (nm_latency_bucket_index (1024), ==, 11);
+	g_assert_cmpint (nm_latency_bucket_index (((guint64) 1) << 38), ==, 39);
+	g_assert_cmpint (nm_latency_bucket_index ((((guint64) 1) << 38) - 1), ==, 38);
+	g_assert_cmpint (nm_latency_bucket_index (((guint64) 1) << 50), ==, NM_LATENCY_HISTOGRAM_BUCKETS - 1);
+	g_assert_cmpint (nm_latency_bucket_index (G_MAXUINT64), ==, NM_LATENCY_HISTOGRAM_BUCKETS - 1);
+
+	for (i = 1; i < 64; i++) {
+		guint64 d = ((guint64) 1) << i;
+
+		g_assert_cmpint (nm_latency_bucket_index (d), ==, MIN (i + 1, NM_LATENCY_HISTOGRAM_BUCKETS - 1));
+		g_assert_cmpint (nm_latency_bucket_index (d - 1), ==, MIN (i, NM_LATENCY_HISTOGRAM_BUCKETS - 1));
+	}
+
+	_latency_stats_get ("dns-update", &count1, &max_ns1, buckets1);
+
+	now_ns = nm_utils_get_monotonic_timestamp_ns ();
+
+	/* a start time in the future counts as zero duration. */
+	nm_latency_record (NM_LATENCY_POINT_DNS_UPDATE, now_ns + NM_UTILS_NS_PER_SECOND);
+	/* a duration of at least 1 ms goes to bucket 20 or later. */
+	nm_latency_record (NM_LATENCY_POINT_DNS_UPDATE, now_ns - 1000000);
+
+	_latency_stats_get ("dns-update", &count2, &max_ns2, buckets2);
+
+	g_assert_cmpuint (count2, ==, count1 + 2);
+	g_assert_cmpuint (max_ns2, >=, 1000000);
+	g_assert_cmpuint (buckets2[0], ==, buckets1[0] + 1);
+	for (i = 1; i < 20; i++)
+		g_assert_cmpuint (buckets2[i], ==, buckets1[i]);
+}
+
+/*****************************************************************************/
+
+static void
+test_dispatcher_script_is_runnable (void)
+{
+	gs_free_error GError *error = NULL;
+	gs_free char *dirname = NULL;
+	gs_free char *subdir = NULL;
+	gs_free char *link1 = NULL;
+	gs_free char *link2 = NULL;
+	gs_free char *link3 = NULL;
+	gs_free char *file = NULL;
+
+	dirname = g_dir_make_tmp ("nm-test-dispatcher-XXXXXX", &error);
+	g_assert_no_error (error);
+
+	subdir = g_build_filename (dirname, "no-wait.d", NULL);
+	g_assert_cmpint (mkdir (subdir, 0755), ==, 0);
+	g_assert (!nm_dispatcher_script_is_runnable (dirname, "no-wait.d"));
+
+	/* a dangling symlink into no-wait.d still counts, because the target
+	 * might show up later without the monitored directory changing. */
+	link1 = g_build_filename (dirname, "10-dangling", NULL);
+	g_assert_cmpint (symlink ("no-wait.d/10-dangling", link1), ==, 0);
+	g_assert (nm_dispatcher_script_is_runnable (dirname, "10-dangling"));
+
+	/* so does a symlink to a non-executable file. */
+	file = g_build_filename (subdir, "20-script", NULL);
+	g_file_set_contents (file, "#!/bin/sh\n", -1, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (chmod (file, 0644), ==, 0);
+	link2 = g_build_filename (dirname, "20-script", NULL);
+	g_assert_cmpint (symlink ("no-wait.d/20-script", link2), ==, 0);
+	g_assert (nm_dispatcher_script_is_runnable (dirname, "20-script"));
+
+	/* but backup files are ignored even if they are symlinks. */
+	link3 = g_build_filename (dirname, "20-script~", NULL);
+	g_assert_cmpint (symlink ("no-wait.d/20-script", link3), ==, 0);
+	g_assert (!nm_dispatcher_script_is_runnable (dirname, "20-script~"));
+
+	g_assert (!nm_dispatcher_script_is_runnable (dirname, "does-not-exist"));
+
+	nmtst_file_unlink (link3);
+	nmtst_file_unlink (link2);
+	nmtst_file_unlink (link1);
+	nmtst_file_unlink (file);
+	g_assert_cmpint (rmdir (subdir), ==, 0);
+	g_assert_cmpint (rmdir (dirname), ==, 0);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -1891,6 +2024,10 @@ main (int argc, char **argv)
 	g_test_add_func ("/general/stable-id/parse", test_stable_id_parse);
 	g_test_add_func ("/general/stable-id/generated-complete", test_stable_id_generated_complete);
 
+	g_test_add_func ("/general/latency-stats", test_latency_stats);
+
+	g_test_add_func ("/general/dispatcher/script-is-runnable", test_dispatcher_script_is_runnable);
+
 	return g_test_run ();
 }
 
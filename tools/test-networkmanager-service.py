@@ -620,6 +620,10 @@ class ExportedObj(dbus.service.Object):
                 elif dbus_iface == IFACE_VPN_CONNECTION:
                     if propname == PRP_VPN_CONNECTION_VPN_STATE:
                         permission_granted = True
+            elif isinstance(self, Device):
+                if dbus_iface == IFACE_DEVICE:
+                    if propname == PRP_DEVICE_IFACE:
+                        permission_granted = True
 
             if not permission_granted:
                 raise TestError("Cannot set property '%s' on '%s' on '%s' via D-Bus" % (propname, dbus_iface, self.path))
@@ -1391,6 +1395,34 @@ class NetworkManager(ExportedObj):
     def GetLogging(self):
         return ("info", "HW,RFKILL,CORE,DEVICE,WIFI,ETHER")
 
+    @dbus.service.method(dbus_interface=IFACE_NM, in_signature='', out_signature='a{su}')
+    def GetMemoryStats(self):
+        return collections.OrderedDict([
+                 ("devices",                   dbus.UInt32(len(self.devices))),
+                 ("ip4-configs",               dbus.UInt32(0)),
+                 ("ip6-configs",               dbus.UInt32(0)),
+                 ("settings-connections",      dbus.UInt32(len(gl.settings.connections))),
+                 ("dedup-index.entries",       dbus.UInt32(0)),
+                 ("dedup-index.objects",       dbus.UInt32(0)),
+               ])
+
+    @dbus.service.method(dbus_interface=IFACE_NM, in_signature='', out_signature='a{s(tttat)}')
+    def GetLatencyStats(self):
+        # Bucket i counts durations with i significant bits, like in the daemon.
+        def stats(samples):
+            buckets = [0] * 40
+            for ns in samples:
+                buckets[min(ns.bit_length(), 39)] += 1
+            return dbus.Struct((dbus.UInt64(len(samples)),
+                                dbus.UInt64(sum(samples)),
+                                dbus.UInt64(max(samples) if samples else 0),
+                                dbus.Array(buckets, 't')))
+        return collections.OrderedDict([
+                 ("netlink-event",             stats([800, 1200, 2500, 40000])),
+                 ("dns-update",                stats([3000000])),
+                 ("settings-write",            stats([])),
+               ])
+
     @dbus.service.method(dbus_interface=IFACE_NM, in_signature='', out_signature='u')
     def CheckConnectivity(self):
         raise BusErr.PermissionDeniedException("You fail")